@@ -0,0 +1,12 @@
+#pragma once
+
+#include <armadillo>
+
+// The core is written in terms of Armadillo's types and functions, which are
+// brought into the owl namespace only, so that code that includes these
+// headers does not see them (or the names of the core) unqualified.
+namespace owl {
+
+using namespace arma;
+
+} // namespace owl
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "arma.h"
+
+namespace owl {
+
+// Statistics of the columns of the raw storage of the design matrix, along
+// with its cross product with a response, for the standardization and the
+// setup of the regularization path. The centered statistics are taken around
+// the column means if center is true and around zero otherwise. All of them
+// are weighted by the (frequency) weights of the observations, so that n_obs
+// is the sum of the weights and xtr and r_sums are computed from w % r.
+struct ColumnStatistics {
+  double n_obs;
+  rowvec center;
+  rowvec l1;
+  rowvec l2;
+  rowvec sd;
+  rowvec max;
+  mat xtr;
+  rowvec r_sums;
+
+  ColumnStatistics(const uword p, const uword m, const double n_obs)
+    : n_obs(n_obs),
+      center(p, fill::zeros),
+      l1(p, fill::zeros),
+      l2(p, fill::zeros),
+      sd(p, fill::zeros),
+      max(p, fill::zeros),
+      xtr(p, m, fill::zeros),
+      r_sums(m, fill::zeros) {}
+
+  // the statistics that follow from the weighted sums (s1) and sums of
+  // squares (s2) of column j, and its maximum
+  void setMoments(const uword j,
+                  const double s1,
+                  const double s2,
+                  const double x_max,
+                  const bool centered)
+  {
+    const double x_bar = s1/n_obs;
+    const double c = centered ? x_bar : 0.0;
+
+    center(j) = c;
+    l2(j) = std::sqrt(std::max(s2 - 2*c*s1 + n_obs*c*c, 0.0));
+    sd(j) = n_obs > 1
+      ? std::sqrt(std::max(s2 - n_obs*x_bar*x_bar, 0.0)/(n_obs - 1))
+      : 0.0;
+    max(j) = x_max - c;
+  }
+};
+
+// the weighted response used in the cross products
+inline mat weightedResponse(const mat& r, const vec& w)
+{
+  mat r_w = r;
+  r_w.each_col() %= w;
+
+  return r_w;
+}
+
+// All statistics are computed in a single pass over each column, with the
+// columns split across threads. The L1 norms (which need the center before
+// they can be computed) take a second, cache-hot, sweep over the column and
+// are only computed if requested.
+inline ColumnStatistics columnStatistics(const mat& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  const uword n = x.n_rows;
+  const uword p = x.n_cols;
+  const uword m = r.n_cols;
+
+  ColumnStatistics stats(p, m, accu(w));
+
+  const mat r_w = weightedResponse(r, w);
+  stats.r_sums = sum(r_w, 0);
+
+  const double* w_ptr = w.memptr();
+
+  #pragma omp parallel for schedule(static)
+  for (uword j = 0; j < p; ++j) {
+    const double* x_j = x.colptr(j);
+
+    // shift by the first value to avoid cancellation in the variance
+    const double shift = x_j[0];
+
+    double s1 = 0.0;
+    double s2 = 0.0;
+    double x_max = x_j[0];
+
+    #pragma omp simd reduction(+:s1, s2) reduction(max:x_max)
+    for (uword i = 0; i < n; ++i) {
+      const double d = x_j[i] - shift;
+      s1 += w_ptr[i]*d;
+      s2 += w_ptr[i]*d*d;
+      x_max = x_j[i] > x_max ? x_j[i] : x_max;
+    }
+
+    for (uword k = 0; k < m; ++k) {
+      const double* r_k = r_w.colptr(k);
+      double xtr = 0.0;
+
+      #pragma omp simd reduction(+:xtr)
+      for (uword i = 0; i < n; ++i)
+        xtr += x_j[i]*r_k[i];
+
+      stats.xtr(j, k) = xtr;
+    }
+
+    const double n_obs = stats.n_obs;
+    const double x_bar = shift + s1/n_obs;
+    const double c = center ? x_bar : 0.0;
+    const double d = shift - c;
+
+    stats.center(j) = c;
+    stats.l2(j) = std::sqrt(std::max(s2 + 2*d*s1 + n_obs*d*d, 0.0));
+    stats.sd(j) = n_obs > 1
+      ? std::sqrt(std::max(s2 - s1*s1/n_obs, 0.0)/(n_obs - 1))
+      : 0.0;
+    stats.max(j) = x_max - c;
+
+    if (l1) {
+      double l1_norm = 0.0;
+
+      #pragma omp simd reduction(+:l1_norm)
+      for (uword i = 0; i < n; ++i)
+        l1_norm += w_ptr[i]*std::abs(x_j[i] - c);
+
+      stats.l1(j) = l1_norm;
+    }
+  }
+
+  return stats;
+}
+
+// for compressed sparse column storage (with indices of any integer type),
+// the implicit zeros are accounted for analytically
+template <typename I>
+ColumnStatistics cscColumnStatistics(const I* col_ptrs,
+                                     const I* row_indices,
+                                     const double* values,
+                                     const uword n,
+                                     const uword p,
+                                     const mat& r,
+                                     const vec& w,
+                                     const bool center,
+                                     const bool l1)
+{
+  const uword m = r.n_cols;
+
+  ColumnStatistics stats(p, m, accu(w));
+
+  const mat r_w = weightedResponse(r, w);
+  stats.r_sums = sum(r_w, 0);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (uword j = 0; j < p; ++j) {
+    const uword start = col_ptrs[j];
+    const uword end = col_ptrs[j + 1];
+    const uword n_nonzero = end - start;
+
+    double s1 = 0.0;
+    double s2 = 0.0;
+    double w_nonzero = 0.0;
+    double x_max = n_nonzero < n ? 0.0 : -datum::inf;
+
+    for (uword ind = start; ind < end; ++ind) {
+      const double v = values[ind];
+      const double w_i = w[row_indices[ind]];
+      s1 += w_i*v;
+      s2 += w_i*v*v;
+      w_nonzero += w_i;
+      x_max = std::max(x_max, v);
+    }
+
+    for (uword k = 0; k < m; ++k) {
+      const double* r_k = r_w.colptr(k);
+      double xtr = 0.0;
+
+      for (uword ind = start; ind < end; ++ind)
+        xtr += values[ind]*r_k[row_indices[ind]];
+
+      stats.xtr(j, k) = xtr;
+    }
+
+    stats.setMoments(j, s1, s2, x_max, center);
+
+    if (l1) {
+      const double c = stats.center(j);
+      double l1_norm = (stats.n_obs - w_nonzero)*std::abs(c);
+
+      for (uword ind = start; ind < end; ++ind)
+        l1_norm += w[row_indices[ind]]*std::abs(values[ind] - c);
+
+      stats.l1(j) = l1_norm;
+    }
+  }
+
+  return stats;
+}
+
+inline ColumnStatistics columnStatistics(const sp_mat& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  x.sync();
+
+  return cscColumnStatistics(x.col_ptrs,
+                             x.row_indices,
+                             x.values,
+                             x.n_rows,
+                             x.n_cols,
+                             r,
+                             w,
+                             center,
+                             l1);
+}
+
+} // namespace owl
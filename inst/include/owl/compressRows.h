@@ -0,0 +1,165 @@
+#pragma once
+
+#include "arma.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+namespace owl {
+
+// The distinct observations of a data set, given as the first of each group
+// of identical rows (of x and y together) and the sum of the weights in the
+// group.
+struct CompressedRows {
+  uvec rows;
+  vec weights;
+};
+
+inline std::uint64_t hashCombine(std::uint64_t h, double v)
+{
+  // -0.0 and 0.0 compare equal, so they must hash equally too
+  v += 0.0;
+
+  std::uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+
+  return h ^ (bits + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+// hash the rows of x, column by column
+inline void hashRows(std::vector<std::uint64_t>& h, const mat& x)
+{
+  for (uword j = 0; j < x.n_cols; ++j) {
+    const double* x_j = x.colptr(j);
+
+    for (uword i = 0; i < x.n_rows; ++i)
+      h[i] = hashCombine(h[i], x_j[i]);
+  }
+}
+
+// only the nonzeros (and their columns) enter the hashes of sparse rows
+inline void hashRows(std::vector<std::uint64_t>& h, const sp_mat& x)
+{
+  x.sync();
+
+  for (uword j = 0; j < x.n_cols; ++j) {
+    for (uword ind = x.col_ptrs[j]; ind < x.col_ptrs[j + 1]; ++ind) {
+      const uword i = x.row_indices[ind];
+      h[i] = hashCombine(hashCombine(h[i], j), x.values[ind]);
+    }
+  }
+}
+
+// are columns a and b of x identical?
+inline bool columnsEqual(const mat& x, const uword a, const uword b)
+{
+  return std::equal(x.begin_col(a), x.end_col(a), x.begin_col(b));
+}
+
+inline bool columnsEqual(const sp_mat& x, const uword a, const uword b)
+{
+  x.sync();
+
+  const uword a_start = x.col_ptrs[a];
+  const uword b_start = x.col_ptrs[b];
+  const uword nnz = x.col_ptrs[a + 1] - a_start;
+
+  if (nnz != x.col_ptrs[b + 1] - b_start)
+    return false;
+
+  for (uword k = 0; k < nnz; ++k) {
+    if (x.row_indices[a_start + k] != x.row_indices[b_start + k]
+        || x.values[a_start + k] != x.values[b_start + k])
+      return false;
+  }
+
+  return true;
+}
+
+// Group identical items by sorting them by their hashes and comparing the
+// items within each run of equal hashes with equal(a, b). Returns the
+// representative (the first item) of the group of each item.
+template <typename Equal>
+uvec groupByHash(const std::vector<std::uint64_t>& h, Equal equal)
+{
+  const uword n = h.size();
+
+  std::vector<uword> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uword a, uword b) {
+    return h[a] < h[b];
+  });
+
+  uvec group(n);
+  std::vector<bool> assigned(n, false);
+
+  uword run_start = 0;
+
+  while (run_start < n) {
+    uword run_end = run_start + 1;
+
+    while (run_end < n && h[order[run_end]] == h[order[run_start]])
+      ++run_end;
+
+    for (uword a = run_start; a < run_end; ++a) {
+      const uword i = order[a];
+
+      if (assigned[i])
+        continue;
+
+      group(i) = i;
+      assigned[i] = true;
+
+      for (uword b = a + 1; b < run_end; ++b) {
+        const uword k = order[b];
+
+        if (!assigned[k] && equal(i, k)) {
+          group(k) = i;
+          assigned[k] = true;
+        }
+      }
+    }
+
+    run_start = run_end;
+  }
+
+  return group;
+}
+
+// Find the duplicate rows of (x, y). The representatives are returned in
+// their original order.
+template <typename T>
+CompressedRows compressRows(const T& x, const mat& y, const vec& w)
+{
+  const uword n = x.n_rows;
+
+  std::vector<std::uint64_t> h(n, 0);
+  hashRows(h, y);
+  hashRows(h, x);
+
+  // rows are compared as the (contiguous) columns of the transposes
+  const T x_t = x.t();
+  const mat y_t = y.t();
+
+  const uvec group = groupByHash(h, [&](uword a, uword b) {
+    return columnsEqual(y_t, a, b) && columnsEqual(x_t, a, b);
+  });
+
+  CompressedRows out;
+  out.rows = find(group == regspace<uvec>(0, n - 1));
+
+  // position of each representative among the distinct rows
+  uvec position(n);
+  position.elem(out.rows) = regspace<uvec>(0, out.rows.n_elem - 1);
+
+  out.weights.zeros(out.rows.n_elem);
+
+  for (uword i = 0; i < n; ++i)
+    out.weights(position(group(i))) += w(i);
+
+  return out;
+}
+
+} // namespace owl
@@ -0,0 +1,829 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "families/families.h"
+#include "hooks.h"
+#include "prox.h"
+#include "results.h"
+#include "standardizedMatrix.h"
+#include "threads.h"
+#include "utils.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace owl {
+
+// Consensus ADMM over shards of the observations (rows of x), each of which
+// is held by a worker process that minimizes its own part of the loss, while
+// the coordinator applies the sorted L1 prox to the average of the workers'
+// solutions (Boyd et al., 2011, section 7.1). The workers are separate
+// programs (see serveShard()), which talk to the coordinator over stream
+// sockets with the messages below and receive their settings and their shard
+// in them too. Each worker holds only its own shard, and the coordinator only
+// the duals and the state of the prox.
+
+// the most passes of the (warm-started) local solver per ADMM iteration
+const uword shard_max_passes = 1000;
+
+// the most halvings of the step size in one pass of the local solver
+const uword shard_max_halvings = 60;
+
+enum ShardCommand : std::uint64_t {
+  // minimize the local loss plus (scalar/2)*||beta - data||^2
+  shard_solve = 1,
+  // the local loss at the coefficients data
+  shard_evaluate = 2,
+  shard_stop = 3,
+  // an array of the shard (see sendShard())
+  shard_setup = 4,
+  // the local solver of a worker failed
+  shard_failed = 5
+};
+
+// the header of a message, which is followed by n doubles
+struct ShardMessage {
+  std::uint64_t command;
+  std::uint64_t n;
+  double scalar;
+};
+
+// the families that the workers set up, by their index in setup messages
+const std::vector<std::string> shard_families = {
+  "gaussian", "binomial", "poisson", "multinomial"
+};
+
+#ifndef _WIN32
+
+inline void sendAll(const int fd, const void* data, std::size_t bytes)
+{
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+
+  const char* ptr = static_cast<const char*>(data);
+
+  while (bytes > 0) {
+    const ssize_t sent = send(fd, ptr, bytes, flags);
+
+    if (sent < 0) {
+      if (errno == EINTR)
+        continue;
+
+      throw std::runtime_error("could not send to a shard worker");
+    }
+
+    ptr += sent;
+    bytes -= sent;
+  }
+}
+
+inline void receiveAll(const int fd, void* data, std::size_t bytes)
+{
+  char* ptr = static_cast<char*>(data);
+
+  while (bytes > 0) {
+    const ssize_t received = recv(fd, ptr, bytes, 0);
+
+    if (received < 0 && errno == EINTR)
+      continue;
+
+    if (received <= 0)
+      throw std::runtime_error("lost the connection to a shard worker");
+
+    ptr += received;
+    bytes -= received;
+  }
+}
+
+inline void sendMessage(const int fd,
+                        const std::uint64_t command,
+                        const double scalar,
+                        const mat& data)
+{
+  const ShardMessage header{command, data.n_elem, scalar};
+
+  sendAll(fd, &header, sizeof(header));
+
+  if (data.n_elem > 0)
+    sendAll(fd, data.memptr(), sizeof(double)*data.n_elem);
+}
+
+// receive a message whose data (if any) has the size of data
+inline ShardMessage receiveMessage(const int fd, mat& data)
+{
+  ShardMessage header;
+
+  receiveAll(fd, &header, sizeof(header));
+
+  if (header.command == shard_failed)
+    throw std::runtime_error("a shard worker could not solve its subproblem");
+
+  if (header.n > 0) {
+    if (header.n != data.n_elem)
+      throw std::runtime_error("malformed message from a shard worker");
+
+    receiveAll(fd, data.memptr(), sizeof(double)*data.n_elem);
+  }
+
+  return header;
+}
+
+#endif
+
+// only in-memory predictors are split into shards
+inline bool canShard(const mat&)
+{
+  return true;
+}
+
+inline bool canShard(const sp_mat&)
+{
+  return true;
+}
+
+template <typename T>
+bool canShard(const T&)
+{
+  return false;
+}
+
+// the storage of a shard in setup messages
+inline uword shardStorage(const mat&)
+{
+  return 0;
+}
+
+inline uword shardStorage(const sp_mat&)
+{
+  return 1;
+}
+
+template <typename T>
+uword shardStorage(const T&)
+{
+  throw std::invalid_argument("only dense and sparse predictors can be "
+                              "split into shards");
+}
+
+#ifndef _WIN32
+
+// Send an array in a setup message, whose scalar is the number of rows, so
+// that the receiver does not need to know its size beforehand
+inline void sendArray(const int fd, const mat& data)
+{
+  sendMessage(fd, shard_setup, data.n_rows, data);
+}
+
+inline mat receiveArray(const int fd)
+{
+  ShardMessage header;
+
+  receiveAll(fd, &header, sizeof(header));
+
+  const double n_rows = header.scalar;
+
+  if (header.command != shard_setup
+      || !(n_rows >= 0 && n_rows <= header.n + 1.0)
+      || n_rows != std::floor(n_rows)
+      || (n_rows == 0 ? header.n != 0 : header.n % uword(n_rows) != 0))
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  mat data(uword(n_rows), n_rows > 0 ? header.n/uword(n_rows) : 0);
+
+  if (header.n > 0)
+    receiveAll(fd, data.memptr(), sizeof(double)*header.n);
+
+  return data;
+}
+
+// indices are sent as doubles, which hold them exactly
+inline uvec receiveIndices(const int fd)
+{
+  const vec data = vectorise(receiveArray(fd));
+
+  if (any(data < 0) || any(data != floor(data)))
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  return conv_to<uvec>::from(data);
+}
+
+// send the rows first to last of x, straight from its columns
+inline void sendRows(const int fd,
+                     const mat& x,
+                     const uword first,
+                     const uword last)
+{
+  const uword n_rows = last - first + 1;
+  const ShardMessage header{shard_setup, n_rows*x.n_cols, double(n_rows)};
+
+  sendAll(fd, &header, sizeof(header));
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    sendAll(fd, x.colptr(j) + first, sizeof(double)*n_rows);
+}
+
+inline void sendRows(const int fd,
+                     const sp_mat& x,
+                     const uword first,
+                     const uword last)
+{
+  const sp_mat rows = x.rows(first, last);
+
+  vec col_ptrs(rows.n_cols + 1);
+  vec row_indices(rows.n_nonzero);
+
+  for (uword j = 0; j <= rows.n_cols; ++j)
+    col_ptrs(j) = rows.col_ptrs[j];
+
+  for (uword i = 0; i < rows.n_nonzero; ++i)
+    row_indices(i) = rows.row_indices[i];
+
+  sendArray(fd, vec{double(rows.n_rows), double(rows.n_cols)});
+  sendArray(fd, col_ptrs);
+  sendArray(fd, row_indices);
+  sendArray(fd, vec(rows.values, rows.n_nonzero));
+}
+
+template <typename T>
+void sendRows(const int, const T&, const uword, const uword)
+{
+  throw std::invalid_argument("only dense and sparse predictors can be "
+                              "split into shards");
+}
+
+inline void receiveRows(const int fd, std::shared_ptr<const mat>& x)
+{
+  x = std::make_shared<const mat>(receiveArray(fd));
+}
+
+inline void receiveRows(const int fd, std::shared_ptr<const sp_mat>& x)
+{
+  const uvec dims = receiveIndices(fd);
+  const uvec col_ptrs = receiveIndices(fd);
+  const uvec row_indices = receiveIndices(fd);
+  const vec values = vectorise(receiveArray(fd));
+
+  bool valid = dims.n_elem == 2
+               && col_ptrs.n_elem == dims(1) + 1
+               && col_ptrs(0) == 0
+               && col_ptrs(dims(1)) == values.n_elem
+               && row_indices.n_elem == values.n_elem
+               && all(row_indices < dims(0));
+
+  for (uword j = 0; valid && j < dims(1); ++j)
+    valid = col_ptrs(j) <= col_ptrs(j + 1);
+
+  if (!valid)
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  x = std::make_shared<const sp_mat>(
+    row_indices, col_ptrs, values, dims(0), dims(1)
+  );
+}
+
+template <typename T>
+void receiveRows(const int, std::shared_ptr<const T>&)
+{
+  throw std::invalid_argument("only dense and sparse predictors can be "
+                              "split into shards");
+}
+
+// Send the settings of a worker and the rows first to last of x (with the
+// standardization of all of x), y and the weights, which it receives with
+// receiveShard(). Only the rows of the shard are sent, and dense rows are
+// not copied first.
+template <typename T>
+void sendShard(const int fd,
+               const StandardizedMatrix<T>& x,
+               const mat& y,
+               const vec& weights,
+               const uword m,
+               const std::string& family,
+               const double tol,
+               const uword first,
+               const uword last)
+{
+  const auto f =
+    std::find(shard_families.begin(), shard_families.end(), family);
+
+  if (f == shard_families.end())
+    throw std::invalid_argument("unknown family for a shard worker");
+
+  sendArray(fd, vec{double(shardStorage(*x.data)),
+                    double(x.intercept),
+                    double(m),
+                    double(f - shard_families.begin())});
+  sendArray(fd, vec{tol});
+  sendArray(fd, x.center);
+  sendArray(fd, x.scale);
+  sendArray(fd, conv_to<vec>::from(x.columns));
+  sendRows(fd, *x.data, first, last);
+  sendArray(fd, y.rows(first, last));
+  sendArray(fd, weights.subvec(first, last));
+}
+
+// receive the shard that follows the settings (for storage T)
+template <typename T>
+void receiveShard(const int fd,
+                  StandardizedMatrix<T>& x,
+                  mat& y,
+                  vec& weights)
+{
+  x.center = receiveArray(fd);
+  x.scale = receiveArray(fd);
+  x.columns = receiveIndices(fd);
+
+  std::shared_ptr<const T> data;
+  receiveRows(fd, data);
+
+  y = receiveArray(fd);
+  weights = vectorise(receiveArray(fd));
+
+  const uword p_data = data->n_cols;
+  const uword p = x.columns.is_empty() ? p_data : x.columns.n_elem;
+
+  if (x.center.n_elem != p
+      || x.scale.n_elem != p
+      || any(x.columns >= p_data)
+      || y.n_rows != data->n_rows
+      || weights.n_elem != data->n_rows)
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  x.data = data;
+  x.n_rows = data->n_rows;
+  x.n_cols = p + static_cast<uword>(x.intercept);
+}
+
+#endif
+
+// Minimize the loss of a shard plus (rho/2)*||beta - v||^2 by accelerated
+// gradient descent with backtracking, starting from beta. The step size is
+// kept between calls. Returns the number of passes, or throws if no step
+// decreases the objective (which happens when it is not finite).
+template <typename T>
+uword solveShard(const Family& family,
+                 const StandardizedMatrix<T>& x,
+                 const mat& y,
+                 mat& beta,
+                 const mat& v,
+                 const double rho,
+                 double& learning_rate,
+                 const double tol)
+{
+  auto objective = [&](const mat& b, mat& lin_pred) {
+    lin_pred = x*b;
+    return family.primal(y, lin_pred) + 0.5*rho*accu(square(b - v));
+  };
+
+  // the penalty may have changed since the last call
+  learning_rate *= 2.0;
+
+  mat theta = beta;
+  mat lin_pred;
+  double t = 1.0;
+  uword passes = 0;
+
+  while (passes < shard_max_passes) {
+    ++passes;
+
+    const double h = objective(theta, lin_pred);
+    const mat grad = family.gradient(x, y, lin_pred) + rho*(theta - v);
+    const double grad_sq = accu(square(grad));
+
+    if (!std::isfinite(h) || !std::isfinite(grad_sq))
+      throw std::runtime_error("the loss of a shard is not finite");
+
+    mat beta_new;
+    mat lin_pred_new;
+
+    for (uword halvings = 0; ; ++halvings) {
+      beta_new = theta - learning_rate*grad;
+
+      if (objective(beta_new, lin_pred_new)
+          <= h - 0.5*learning_rate*grad_sq + 1e-12*std::abs(h))
+        break;
+
+      if (halvings == shard_max_halvings)
+        throw std::runtime_error("the local solver of a shard found no step "
+                                 "that decreases its objective");
+
+      learning_rate *= 0.5;
+    }
+
+    const double t_old = t;
+    t = 0.5*(1.0 + std::sqrt(1.0 + 4.0*t_old*t_old));
+    theta = beta_new + (t_old - 1.0)/t*(beta_new - beta);
+
+    const double change = norm(vectorise(beta_new - beta));
+    beta = beta_new;
+
+    if (change <= tol*std::max(1.0, norm(vectorise(beta))))
+      break;
+  }
+
+  return passes;
+}
+
+#ifndef _WIN32
+
+// answer the coordinator's messages on fd until it says stop, or until the
+// local solver fails, which the coordinator is told about
+template <typename T>
+void serveShard(const int fd,
+                const StandardizedMatrix<T>& x,
+                const mat& y,
+                const Family& family,
+                const uword m,
+                const double tol)
+{
+  mat beta(x.n_cols, m, fill::zeros);
+  mat v(x.n_cols, m);
+  double learning_rate = 1.0;
+
+  while (true) {
+    const ShardMessage message = receiveMessage(fd, v);
+
+    if (message.command == shard_solve) {
+      try {
+        solveShard(family, x, y, beta, v, message.scalar, learning_rate, tol);
+      } catch (const std::runtime_error&) {
+        sendMessage(fd, shard_failed, 0.0, mat());
+        return;
+      }
+
+      sendMessage(fd, shard_solve, 0.0, beta);
+
+    } else if (message.command == shard_evaluate) {
+      sendMessage(fd, shard_evaluate, family.primal(y, x*v), mat());
+
+    } else {
+      return;
+    }
+  }
+}
+
+// receive the shard of storage T and serve it with the given settings
+template <typename T>
+void serveShard(const int fd,
+                const bool intercept,
+                const uword m,
+                const std::string& family_choice,
+                const double tol)
+{
+  StandardizedMatrix<T> x;
+  x.intercept = intercept;
+  mat y;
+  vec weights;
+
+  receiveShard(fd, x, y, weights);
+
+  // only the loss and its gradient are used
+  auto family = setupFamily(family_choice,
+                            y,
+                            intercept,
+                            false,
+                            shard_max_passes,
+                            0.0,
+                            0.0,
+                            0.0,
+                            tol,
+                            uword(0),
+                            std::chrono::steady_clock::time_point::max(),
+                            weights,
+                            FitHooks());
+
+  serveShard(fd, x, y, *family, m, tol);
+}
+
+// The entry point of a worker, in a process of its own that only needs the
+// socket fd connected to the coordinator: the settings and the shard are
+// received in the setup messages of sendShard(), and then the coordinator's
+// messages are answered until it says stop.
+inline void serveShard(const int fd)
+{
+  const uvec settings = receiveIndices(fd);
+
+  if (settings.n_elem != 4
+      || settings(0) > 1
+      || settings(1) > 1
+      || settings(2) == 0
+      || settings(3) >= shard_families.size())
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  const vec tol = vectorise(receiveArray(fd));
+
+  if (tol.n_elem != 1)
+    throw std::runtime_error("malformed setup message from the coordinator");
+
+  const bool intercept = settings(1) == 1;
+  const std::string& family = shard_families[settings(3)];
+
+  if (settings(0) == 0)
+    serveShard<mat>(fd, intercept, settings(2), family, tol(0));
+  else
+    serveShard<sp_mat>(fd, intercept, settings(2), family, tol(0));
+}
+
+#endif
+
+// The coordinator, which starts one worker process for each shard of
+// (consecutive) observations when it is constructed, sends them their
+// settings and shards, and stops them when it is destroyed. The workers are
+// started (without forking this process, which may have threads running) by
+// the program and arguments in worker_command, followed by the number of the
+// worker's end of the socket, which it inherits; the program must pass it to
+// serveShard(). The coordinator reads x only to send the shards.
+template <typename T>
+class ConsensusADMM {
+public:
+  ConsensusADMM(const StandardizedMatrix<T>& x,
+                const mat& y,
+                const vec& weights,
+                const uword n_shards,
+                const uword m,
+                const std::string& family,
+                const std::vector<std::string>& worker_command,
+                const uword max_passes,
+                const double tol_abs,
+                const double tol_rel,
+                const bool diagnostics,
+                const std::chrono::steady_clock::time_point deadline,
+                const FitHooks& hooks)
+    : m(m),
+      p_rows(x.n_cols - static_cast<uword>(x.intercept)),
+      copies(x.copies),
+      max_passes(max_passes),
+      tol_abs(tol_abs),
+      tol_rel(tol_rel),
+      diagnostics(diagnostics),
+      deadline(deadline),
+      hooks(hooks)
+  {
+#ifdef _WIN32
+    throw std::runtime_error("distributed fits are not supported on Windows");
+#else
+    if (!canShard(*x.data))
+      throw std::invalid_argument("only dense and sparse predictors can be "
+                                  "split into shards");
+
+    if (worker_command.empty())
+      throw std::invalid_argument("no command to start the shard workers");
+
+    const uword n = x.n_rows;
+    const uword n_workers = std::min(n_shards, n);
+
+    for (uword s = 0; s < n_workers; ++s) {
+      int fds[2];
+
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+        stopWorkers();
+        throw std::runtime_error("could not connect to a shard worker");
+      }
+
+      // the coordinator's ends are not inherited by the workers
+      fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+#ifdef SO_NOSIGPIPE
+      const int on = 1;
+      setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+      setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+      std::vector<std::string> args = worker_command;
+      args.push_back(std::to_string(fds[1]));
+
+      std::vector<char*> argv;
+
+      for (auto& arg : args)
+        argv.push_back(&arg[0]);
+
+      argv.push_back(nullptr);
+
+      // the workers get a process group of their own, so that interrupts
+      // from the terminal are left to the coordinator, which stops them
+      posix_spawnattr_t attributes;
+      posix_spawnattr_init(&attributes);
+      posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+      posix_spawnattr_setpgroup(&attributes, 0);
+
+      pid_t pid;
+      const int error = posix_spawnp(&pid,
+                                     argv[0],
+                                     nullptr,
+                                     &attributes,
+                                     argv.data(),
+                                     environ);
+
+      posix_spawnattr_destroy(&attributes);
+      close(fds[1]);
+
+      if (error != 0) {
+        close(fds[0]);
+        stopWorkers();
+        throw std::runtime_error("could not start a shard worker");
+      }
+
+      sockets.push_back(fds[0]);
+      pids.push_back(static_cast<int>(pid));
+
+      try {
+        sendShard(fds[0],
+                  x,
+                  y,
+                  weights,
+                  m,
+                  family,
+                  tol_rel,
+                  s*n/n_workers,
+                  (s + 1)*n/n_workers - 1);
+      } catch (...) {
+        stopWorkers();
+        throw;
+      }
+    }
+#endif
+  }
+
+  ~ConsensusADMM()
+  {
+    stopWorkers();
+  }
+
+  ConsensusADMM(const ConsensusADMM&) = delete;
+  ConsensusADMM& operator=(const ConsensusADMM&) = delete;
+
+  // Fit the point with the penalty lambda (for the non-intercept rows),
+  // starting from beta and from the scaled duals of the previous point
+  Results fit(const mat& beta, const vec& lambda)
+  {
+#ifdef _WIN32
+    return Results();
+#else
+    const uword n_workers = sockets.size();
+
+    mat z = beta;
+
+    if (u.size() != n_workers || u[0].n_rows != z.n_rows)
+      u.assign(n_workers, mat(z.n_rows, z.n_cols, fill::zeros));
+
+    std::vector<mat> betas(n_workers, mat(z.n_rows, z.n_cols));
+
+    wall_clock timer;
+    std::vector<double> primals;
+    std::vector<double> duals;
+    std::vector<double> time;
+
+    if (diagnostics)
+      timer.tic();
+
+    uword passes = 0;
+    bool converged = false;
+
+    while (passes < max_passes) {
+      ++passes;
+
+      // the workers solve their subproblems at the same time
+      for (uword s = 0; s < n_workers; ++s)
+        sendMessage(sockets[s], shard_solve, rho, z - u[s]);
+
+      for (uword s = 0; s < n_workers; ++s)
+        receiveMessage(sockets[s], betas[s]);
+
+      const mat z_old = z;
+
+      mat average(z.n_rows, z.n_cols, fill::zeros);
+
+      for (uword s = 0; s < n_workers; ++s)
+        average += betas[s] + u[s];
+
+      average /= n_workers;
+
+      z = average;
+      z.tail_rows(p_rows) =
+        prox(average.tail_rows(p_rows), lambda/(n_workers*rho), copies);
+
+      double r_sq = 0.0;
+      double beta_sq = 0.0;
+      double u_sq = 0.0;
+
+      for (uword s = 0; s < n_workers; ++s) {
+        u[s] += betas[s] - z;
+        r_sq += accu(square(betas[s] - z));
+        beta_sq += accu(square(betas[s]));
+        u_sq += accu(square(u[s]));
+      }
+
+      const double r_norm = std::sqrt(r_sq);
+      const double s_norm =
+        rho*std::sqrt(n_workers)*norm(vectorise(z - z_old));
+
+      const double root = std::sqrt(n_workers*z.n_elem);
+      const double eps_primal =
+        root*tol_abs
+        + tol_rel*std::max(std::sqrt(beta_sq),
+                           std::sqrt(n_workers)*norm(vectorise(z)));
+      const double eps_dual = root*tol_abs + tol_rel*rho*std::sqrt(u_sq);
+
+      if (diagnostics) {
+        primals.push_back(r_norm);
+        duals.push_back(s_norm);
+        time.push_back(timer.toc());
+      }
+
+      if (r_norm < eps_primal && s_norm < eps_dual) {
+        converged = true;
+        break;
+      }
+
+      if (std::chrono::steady_clock::now() >= deadline)
+        break;
+
+      checkCancelled(hooks);
+
+      // keep the residuals balanced (Boyd et al., 2011, section 3.4.1); the
+      // duals are scaled by 1/rho
+      if (r_norm > 10.0*s_norm) {
+        rho *= 2.0;
+
+        for (auto& u_s : u)
+          u_s /= 2.0;
+      } else if (s_norm > 10.0*r_norm) {
+        rho /= 2.0;
+
+        for (auto& u_s : u)
+          u_s *= 2.0;
+      }
+    }
+
+    double loss = 0.0;
+    mat none;
+
+    for (uword s = 0; s < n_workers; ++s)
+      sendMessage(sockets[s], shard_evaluate, 0.0, z);
+
+    for (uword s = 0; s < n_workers; ++s)
+      loss += receiveMessage(sockets[s], none).scalar;
+
+    return Results(z, passes, primals, duals, time, 2*loss, converged);
+#endif
+  }
+
+private:
+  const uword m;
+  // the penalized rows and the copies of the columns they stand for
+  const uword p_rows;
+  const uvec copies;
+  const uword max_passes;
+  const double tol_abs;
+  const double tol_rel;
+  const bool diagnostics;
+  const std::chrono::steady_clock::time_point deadline;
+  const FitHooks hooks;
+
+  double rho = 1.0;
+  std::vector<mat> u;
+
+  std::vector<int> sockets;
+  std::vector<int> pids;
+
+  void stopWorkers()
+  {
+#ifndef _WIN32
+    for (uword s = 0; s < sockets.size(); ++s) {
+      try {
+        sendMessage(sockets[s], shard_stop, 0.0, mat());
+      } catch (...) {
+        // the worker is already gone
+      }
+
+      close(sockets[s]);
+      waitpid(pids[s], nullptr, 0);
+    }
+
+    sockets.clear();
+    pids.clear();
+#endif
+  }
+};
+
+} // namespace owl
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "arma.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include "path.h"
+#include "predict.h"
+#include "standardizedMatrix.h"
+#include "threads.h"
+
+namespace owl {
+
+// the probabilities are clamped to [score_prob_min, 1 - score_prob_min] in
+// the deviances, as in score()
+const double score_prob_min = 1e-5;
+
+// area under the ROC curve of the probabilities prob for the classes t (0 or
+// 1), with ties counted as halves
+inline double rocArea(const vec& prob, const vec& t)
+{
+  const uword n = prob.n_elem;
+  const uvec order = sort_index(prob);
+
+  // ranks, averaged within ties
+  vec ranks(n);
+  uword i = 0;
+
+  while (i < n) {
+    uword j = i;
+
+    while (j + 1 < n && prob(order(j + 1)) == prob(order(i)))
+      ++j;
+
+    for (uword k = i; k <= j; ++k)
+      ranks(order(k)) = 0.5*(i + j) + 1.0;
+
+    i = j + 1;
+  }
+
+  const double n1 = accu(t);
+  const double n0 = n - n1;
+
+  return (dot(ranks, t) - n1*(n1 + 1.0)/2.0)/(n1*n0);
+}
+
+// A measure (as in score()) of the predictions at one point along a path,
+// given by the linear predictors lin_pred, for the responses y (as
+// preprocessed for the fit). Unknown measures give NaN.
+inline double scorePoint(const mat& lin_pred,
+                         const mat& y,
+                         const std::string& family,
+                         const std::string& measure,
+                         const double y_center)
+{
+  const uword n = y.n_rows;
+
+  if (family == "gaussian" || family == "poisson") {
+    const bool gaussian = family == "gaussian";
+    const vec y_hat = gaussian ? vec(lin_pred.col(0)) : exp(lin_pred.col(0));
+    const vec y_obs = gaussian ? y.col(0) + y_center : y.col(0);
+
+    if (measure == "mse")
+      return mean(square(y_hat - y_obs));
+    else if (measure == "mae")
+      return mean(abs(y_hat - y_obs));
+
+  } else if (family == "binomial") {
+    // y is -1 or 1 internally
+    const vec t = 0.5*(y.col(0) + 1.0);
+    const vec prob = 1.0/(1.0 + exp(-lin_pred.col(0)));
+
+    if (measure == "mse") {
+      return mean(2.0*square(prob - t));
+    } else if (measure == "mae") {
+      return mean(2.0*abs(prob - t));
+    } else if (measure == "deviance") {
+      const vec p = clamp(prob, score_prob_min, 1.0 - score_prob_min);
+      return -2.0*mean(t % log(p) + (1.0 - t) % log(1.0 - p));
+    } else if (measure == "misclass") {
+      return mean(conv_to<vec>::from((prob > 0.5) != (t > 0.5)));
+    } else if (measure == "auc") {
+      return rocArea(prob, t);
+    }
+
+  } else if (family == "multinomial") {
+    // y holds the class labels, where the last class is the reference class
+    const uword n_classes = lin_pred.n_cols + 1;
+
+    mat prob(n, n_classes, fill::zeros);
+    prob.head_cols(n_classes - 1) = lin_pred;
+    prob.each_col() -= max(prob, 1);
+    prob = exp(prob);
+    prob.each_col() /= sum(prob, 1);
+
+    mat y_hot(n, n_classes, fill::zeros);
+
+    for (uword i = 0; i < n; ++i)
+      y_hot(i, static_cast<uword>(y(i))) = 1.0;
+
+    if (measure == "mse") {
+      return mean(vectorise(square(y_hot - prob)));
+    } else if (measure == "mae") {
+      return mean(vectorise(abs(y_hot - prob)));
+    } else if (measure == "deviance") {
+      const mat p = clamp(prob, score_prob_min, 1.0 - score_prob_min);
+      return -2.0*accu(y_hot % log(p))/n;
+    } else if (measure == "misclass") {
+      const uvec predicted = index_max(prob, 1);
+      return mean(conv_to<vec>::from(predicted != conv_to<uvec>::from(y)));
+    }
+  }
+
+  return datum::nan;
+}
+
+// the measures (columns) at each point (rows) along a path, for linear
+// predictors with the m columns of each point next to each other
+inline mat scorePath(const mat& lin_pred,
+                     const mat& y,
+                     const std::string& family,
+                     const std::vector<std::string>& measures,
+                     const uword m,
+                     const double y_center)
+{
+  const uword n_points = lin_pred.n_cols/m;
+
+  mat out(n_points, measures.size());
+
+  for (uword k = 0; k < n_points; ++k) {
+    const mat lin_pred_k = lin_pred.cols(k*m, k*m + m - 1);
+
+    for (uword l = 0; l < measures.size(); ++l)
+      out(k, l) = scorePoint(lin_pred_k, y, family, measures[l], y_center);
+  }
+
+  return out;
+}
+
+// Cross-validate the paths for each q in settings.q on data that is shared
+// by all of the fits. Fit r*n_folds + f leaves out the observations i with
+// folds(i, r) == f by giving them zero weight, so the data is never copied,
+// and starts each point along its first path from the solution to the full
+// data in warm_start (if it is not empty). The fits are run n_threads at a
+// time, and the measures are computed for the left-out observations as soon
+// as each fit is done. Returns the measures at each sigma (rows) for each
+// measure and q (columns, with the measures for each q next to each other)
+// and fit (slices), which are NaN for points that were not fit.
+template <typename T>
+cube crossValidate(const std::shared_ptr<const T>& data,
+                   const mat& y,
+                   const vec& weights,
+                   const umat& folds,
+                   const uword n_folds,
+                   PathSettings settings,
+                   const sp_mat& warm_start,
+                   const std::vector<std::string>& measures,
+                   const int n_threads)
+{
+  const uword n_fits = n_folds*folds.n_cols;
+  const uword n_measures = measures.size();
+  const uword m = settings.n_targets;
+  const bool intercept = settings.intercept;
+  const double y_center = settings.y_center(0);
+
+  // the fits share the storage, run on threads (which must not fork or start
+  // threads of their own), and must not use the R API
+  settings.rebuild_storage = false;
+  settings.verbosity = 0;
+  settings.diagnostics = false;
+  settings.resume = false;
+  settings.n_shards = 1;
+  settings.pipelined = false;
+
+  cube scores(settings.sigma.n_elem, n_measures*settings.q.n_elem, n_fits);
+  scores.fill(datum::nan);
+
+  parallelTasks(n_fits, n_threads, [&](const uword t, const int) {
+    const uvec test = find(folds.col(t/n_folds) == t % n_folds);
+
+    vec w = weights;
+    w(test).zeros();
+
+    StandardizedMatrix<T> x(data, intercept);
+    const std::vector<PathFit> fits =
+      fitPaths(x, y, w, settings, warm_start);
+
+    for (uword i = 0; i < fits.size(); ++i) {
+      // only the left-out observations and the active predictors are read
+      const sp_mat& coefficients = fits[i].coefficients;
+      const ActiveCoefficients coefs =
+        activeCoefficients(coefficients,
+                           intercept,
+                           m,
+                           pathPoints(coefficients.n_cols/m));
+      const mat lin_pred = linearPredictors(*data, test, coefs);
+
+      const mat s = scorePath(lin_pred,
+                              y.rows(test),
+                              settings.family,
+                              measures,
+                              m,
+                              y_center);
+
+      scores.slice(t).submat(0, i*n_measures, size(s)) = s;
+    }
+  });
+
+  return scores;
+}
+
+} // namespace owl
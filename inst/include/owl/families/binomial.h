@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../arma.h"
+#include "family.h"
+#include "../results.h"
+#include "../vectorMath.h"
+
+namespace owl {
+
+class Binomial : public Family {
+public:
+  template <typename... Ts>
+  Binomial(Ts... args) : Family(std::forward<Ts>(args)...) {}
+
+  double primal(const mat& y, const mat& lin_pred) const
+  {
+    return accu(weigh(log1pExp(-y % lin_pred)));
+  }
+
+  // with r = 1/(1 + exp(t)), log(r) = -log(1 + exp(t)) and log(1 - r) =
+  // t - log(1 + exp(t)), so that a single log1pExp() covers both logarithms
+  double dual(const mat& y, const mat& lin_pred) const
+  {
+    const mat t = y % lin_pred;
+    const mat log1p_exp = log1pExp(t);
+    const mat r = fastExp(-log1p_exp);
+
+    return accu(weigh((r - 1.0) % (t - log1p_exp) + r % log1p_exp));
+  }
+
+  mat pseudoGradient(const mat& y, const mat& lin_pred) const
+  {
+    return weigh(-y / (1.0 + fastExp(y % lin_pred)));
+  }
+
+  rowvec fitNullModel(const mat& y, const uword n_classes)
+  {
+    double pmin = 1e-9;
+    double pmax = 1 - pmin;
+
+    vec mu = clamp(mean(0.5*y + 0.5), pmin, pmax);
+
+    return trunc_log(mu/(1 - mu));
+  }
+
+  std::string name()
+  {
+    return "binomial";
+  }
+};
+
+} // namespace owl
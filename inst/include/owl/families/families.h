@@ -1,28 +1,30 @@
 #pragma once
 
-#include <RcppArmadillo.h>
-
-using namespace Rcpp;
-using namespace arma;
-
+#include "../arma.h"
+#include <memory>
+#include <string>
 #include "family.h"
 #include "gaussian.h"
 #include "binomial.h"
 #include "poisson.h"
 #include "multinomial.h"
 
-// helper to choose family
+namespace owl {
+
+// helper to choose family, which is set up for the response y
 template <typename... Ts>
 inline std::unique_ptr<Family> setupFamily(const std::string& family_choice,
+                                           const mat& y,
                                            Ts... args)
 {
   if (family_choice == "binomial")
     return std::unique_ptr<Binomial>(new Binomial{std::forward<Ts>(args)...});
   else if (family_choice == "poisson")
-    return std::unique_ptr<Poisson>(new Poisson{std::forward<Ts>(args)...});
+    return std::unique_ptr<Poisson>(new Poisson{y, std::forward<Ts>(args)...});
   else if (family_choice == "multinomial")
     return std::unique_ptr<Multinomial>(new Multinomial{std::forward<Ts>(args)...});
   else
     return std::unique_ptr<Gaussian>(new Gaussian{std::forward<Ts>(args)...});
 }
 
+} // namespace owl
@@ -0,0 +1,369 @@
+#pragma once
+
+#include "../arma.h"
+#include <chrono>
+#include <sstream>
+#include "../results.h"
+#include "../utils.h"
+#include "../standardizedMatrix.h"
+#include "../mappedMatrix.h"
+#include "../genotypeMatrix.h"
+#include "../hybridMatrix.h"
+#include "../patternMatrix.h"
+#include "../sortedMagnitudes.h"
+#include "../infeasibility.h"
+#include "../prox.h"
+#include "../hooks.h"
+
+namespace owl {
+
+class Family {
+protected:
+  const bool intercept;
+  const bool diagnostics;
+  const uword max_passes;
+  const double tol_rel_gap;
+  const double tol_infeas;
+  const double tol_abs;
+  const double tol_rel;
+  const uword verbosity;
+  const std::chrono::steady_clock::time_point deadline;
+  // (frequency) weights of the observations
+  const vec weights;
+  const bool weighted;
+  const FitHooks hooks;
+
+  // scale the rows (observations) of a by their weights
+  mat weigh(mat a) const
+  {
+    if (weighted)
+      a.each_col() %= weights;
+
+    return a;
+  }
+
+public:
+  Family(const bool intercept,
+         const bool diagnostics,
+         const uword max_passes,
+         const double tol_rel_gap,
+         const double tol_infeas,
+         const double tol_abs,
+         const double tol_rel,
+         const uword verbosity,
+         const std::chrono::steady_clock::time_point deadline,
+         const vec& weights,
+         const FitHooks& hooks)
+    : intercept(intercept),
+      diagnostics(diagnostics),
+      max_passes(max_passes),
+      tol_rel_gap(tol_rel_gap),
+      tol_infeas(tol_infeas),
+      tol_abs(tol_abs),
+      tol_rel(tol_rel),
+      verbosity(verbosity),
+      deadline(deadline),
+      weights(weights),
+      weighted(any(weights != 1)),
+      hooks(hooks) {}
+
+  // has the time budget for the fit been spent?
+  bool timeUp() const
+  {
+    return std::chrono::steady_clock::now() >= deadline;
+  }
+
+  // the loss, its dual and its gradient only read the family, so that they
+  // can be evaluated on one thread while another one fits
+  virtual double primal(const mat& y, const mat& lin_pred) const = 0;
+
+  virtual double dual(const mat& y, const mat& lin_pred) const = 0;
+
+  // this is not really the true gradient; it needs to multiplied by X^T
+  virtual mat pseudoGradient(const mat& y, const mat& lin_pred) const = 0;
+
+  template <typename T>
+  mat gradient(const T& x, const mat&y, const mat& lin_pred) const
+  {
+    return x.t() * pseudoGradient(y, lin_pred);
+  }
+
+  virtual rowvec fitNullModel(const mat& y, const uword n_classes) = 0;
+
+  virtual std::string name() = 0;
+
+  virtual Results fit(const StandardizedMatrix<mat>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<sp_mat>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<MappedDenseMatrix>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<MappedSparseMatrix>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<GenotypeMatrix>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<HybridMatrix>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  virtual Results fit(const StandardizedMatrix<PatternMatrix>& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  // FISTA implementation
+  template <typename T>
+  Results fitImpl(const T& x,
+                  const mat& y,
+                  mat beta,
+                  vec& z,
+                  vec& u,
+                  const mat& L,
+                  const mat& U,
+                  const vec& xTy,
+                  vec lambda,
+                  double rho)
+  {
+    uword n = y.n_rows;
+    uword p = x.n_cols;
+    uword m = beta.n_cols;
+    // the penalized rows, some of which may stand for several copies of a
+    // column (see pruneColumns())
+    uword p_rows = p - static_cast<uword>(intercept);
+
+    mat beta_tilde(beta);
+    mat beta_tilde_old(beta);
+
+    mat lin_pred(n, m);
+    mat grad(p, m, fill::zeros);
+
+    // sorted magnitudes of the coefficients and gradient, which are kept
+    // between passes since their orderings change little
+    SortedMagnitudes abs_beta;
+    SortedMagnitudes abs_grad;
+
+    double learning_rate = 1.0;
+
+    // line search parameters
+    double eta = 0.5;
+    const uword max_halvings = 60;
+
+    // FISTA parameters
+    double t = 1;
+
+    // diagnostics
+    wall_clock timer;
+    std::vector<double> primals;
+    std::vector<double> duals;
+    std::vector<double> time;
+
+    if (diagnostics) {
+      primals.reserve(max_passes);
+      duals.reserve(max_passes);
+      time.reserve(max_passes);
+      timer.tic();
+    }
+
+    // main loop
+    uword passes = 0;
+    bool converged = false;
+
+    while (passes < max_passes) {
+      lin_pred = x*beta;
+
+      double g = primal(y, lin_pred);
+
+      abs_beta.update(beta.tail_rows(p_rows), x.copies);
+      double h = abs_beta.penalty(lambda);
+      double f = g + h;
+      double G = dual(y, lin_pred);
+
+      grad = gradient(x, y, lin_pred);
+
+      double infeas = 0.0;
+
+      if (lambda.n_elem > 0) {
+        abs_grad.update(grad.tail_rows(p_rows), x.copies);
+        infeas = infeasibility(abs_grad, lambda);
+      }
+      if (verbosity >= 3) {
+        std::ostringstream line;
+        line.precision(4);
+        line << "pass: "            << passes
+             << ", duality-gap: "   << std::abs(f - G)/std::abs(f)
+             << ", infeasibility: " << infeas;
+        logLine(hooks, line.str());
+      }
+
+      double small = std::sqrt(datum::eps);
+
+      bool optimal =
+        (std::abs(f - G)/std::max(small, std::abs(f)) < tol_rel_gap);
+
+      bool feasible =
+        lambda.n_elem > 0 ? infeas <= std::max(small, tol_infeas*lambda(0))
+                          : true;
+
+      if (diagnostics) {
+        time.push_back(timer.toc());
+        primals.push_back(f);
+        duals.push_back(G);
+      }
+
+      if (optimal && feasible) {
+        converged = true;
+        break;
+      }
+
+      if (timeUp())
+        break;
+
+      beta_tilde_old = beta_tilde;
+
+      double g_old = g;
+      double t_old = t;
+
+      // Backtracking line search, which gives up (and stops the fit) after
+      // max_halvings halvings or when the time is up
+      bool stalled = false;
+
+      for (uword halvings = 0; ; ++halvings) {
+        // Update coefficients
+        beta_tilde = beta - learning_rate*grad;
+
+        beta_tilde.tail_rows(p_rows) =
+          prox(beta_tilde.tail_rows(p_rows), lambda*learning_rate, x.copies);
+
+        vec d = vectorise(beta_tilde - beta);
+
+        lin_pred = x*beta_tilde;
+
+        g = primal(y, lin_pred);
+
+        double q = g_old
+          + dot(d, vectorise(grad))
+          + (1.0/(2*learning_rate))*accu(square(d));
+
+          if (q >= g*(1 - 1e-12))
+            break;
+
+          if (halvings == max_halvings || timeUp()) {
+            stalled = true;
+            break;
+          }
+
+          learning_rate *= eta;
+
+          checkCancelled(hooks);
+      }
+
+      // keep the last accepted coefficients
+      if (stalled) {
+        lin_pred = x*beta;
+        break;
+      }
+
+      // FISTA step
+      t = 0.5*(1.0 + std::sqrt(1.0 + 4.0*t_old*t_old));
+      beta = beta_tilde + (t_old - 1.0)/t * (beta_tilde - beta_tilde_old);
+
+      if (passes % 100 == 0)
+        checkCancelled(hooks);
+
+      ++passes;
+    }
+
+    double deviance = 2*primal(y, lin_pred);
+
+    Results res{beta,
+                passes,
+                primals,
+                duals,
+                time,
+                deviance,
+                converged};
+
+    return res;
+  }
+};
+
+} // namespace owl
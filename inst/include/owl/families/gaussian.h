@@ -0,0 +1,269 @@
+#pragma once
+
+#include "../arma.h"
+#include "family.h"
+#include "../results.h"
+#include "../utils.h"
+#include "../infeasibility.h"
+#include "../prox.h"
+
+namespace owl {
+
+class Gaussian : public Family {
+private:
+  double alpha = 1.5;
+
+public:
+  template <typename... Ts>
+  Gaussian(Ts... args) : Family(std::forward<Ts>(args)...) {}
+
+  double primal(const mat& y, const mat& lin_pred) const
+  {
+    return 0.5*accu(weigh(square(y - lin_pred)));
+  }
+
+  double dual(const mat& y, const mat& lin_pred) const
+  {
+    return 0.5*accu(weigh(square(y))) - 0.5*accu(weigh(square(lin_pred)));
+  }
+
+  mat pseudoGradient(const mat& y, const mat& lin_pred) const
+  {
+    return weigh(lin_pred - y);
+  }
+
+  rowvec fitNullModel(const mat& y, const uword n_classes)
+  {
+    return mean(y);
+  }
+
+  std::string name()
+  {
+    return "gaussian";
+  }
+
+  Results fit(const StandardizedMatrix<mat>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<sp_mat>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<MappedDenseMatrix>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<MappedSparseMatrix>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<GenotypeMatrix>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<HybridMatrix>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  Results fit(const StandardizedMatrix<PatternMatrix>& x,
+              const mat& y,
+              mat beta,
+              vec& z,
+              vec& u,
+              const mat& L,
+              const mat& U,
+              const vec& xTy,
+              vec lambda,
+              double rho)
+  {
+    return fitGaussian(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  // the ADMM solver uses a factorization of the unweighted Gram matrix, so
+  // weighted problems are solved with FISTA instead
+  template <typename T>
+  Results fitGaussian(const T& x,
+                      const mat& y,
+                      mat beta,
+                      vec& z,
+                      vec& u,
+                      const mat& L,
+                      const mat& U,
+                      const vec& xTy,
+                      vec lambda,
+                      double rho)
+  {
+    if (weighted)
+      return fitImpl(x, y, beta, z, u, L, U, xTy, lambda, rho);
+
+    return fitADMM(x, y, beta, z, u, L, U, xTy, lambda, rho);
+  }
+
+  // ADMM implementation
+  template <typename T>
+  Results fitADMM(const T& x,
+                  const mat& y,
+                  mat beta,
+                  vec& z,
+                  vec& u,
+                  const mat& L,
+                  const mat& U,
+                  const vec& xTy,
+                  vec lambda,
+                  double rho)
+  {
+    std::vector<double> primals;
+    std::vector<double> duals;
+    std::vector<double> infeasibilities;
+    std::vector<double> time;
+
+    uword p = x.n_cols;
+    uword n = x.n_rows;
+    uword p_rows = p - static_cast<uword>(intercept);
+
+    wall_clock timer;
+
+    if (diagnostics)
+      timer.tic();
+
+    vec beta_hat(beta);
+
+    vec z_old(z);
+    vec q;
+
+    vec lin_pred(n);
+    vec grad(p);
+
+    // ADMM loop
+    uword passes = 0;
+    bool converged = false;
+
+    while (passes < max_passes) {
+      ++passes;
+
+      q = xTy + rho*(z - u);
+
+      if (n >= p) {
+        beta = solve(trimatu(U), solve(trimatl(L), q));
+      } else {
+        beta = q/rho -
+          (x.t() * solve(trimatu(U), solve(trimatl(L), x*q)))/(rho*rho);
+      }
+
+      z_old = z;
+      beta_hat = alpha*beta + (1 - alpha)*z_old;
+
+      z = beta_hat + u;
+      z.tail(p_rows) = prox(z.tail(p_rows), lambda/rho, x.copies);
+
+      u += (beta_hat - z);
+
+      double r_norm = norm(beta - z);
+      double s_norm = norm(rho*(z - z_old));
+
+      double eps_primal =
+        std::sqrt(n)*tol_abs + tol_rel*std::max(norm(beta), norm(z));
+      double eps_dual = std::sqrt(n)*tol_abs + tol_rel*norm(rho*u);
+
+      if (diagnostics) {
+        primals.push_back(r_norm);
+        duals.push_back(s_norm);
+        time.push_back(timer.toc());
+      }
+
+      if (verbosity >= 3) {
+        std::ostringstream line;
+        line.precision(4);
+        line << "pass: "              << passes
+             << ", primal residual: " << r_norm
+             << ", dual residual: "   << s_norm;
+        logLine(hooks, line.str());
+      }
+
+      if (r_norm < eps_primal && s_norm < eps_dual) {
+        converged = true;
+        break;
+      }
+
+      if (timeUp())
+        break;
+
+      checkCancelled(hooks);
+    }
+
+    double deviance = 2*primal(y, x*z);
+
+    Results res{z,
+                passes,
+                primals,
+                duals,
+                time,
+                deviance,
+                converged};
+
+    return res;
+  }
+};
+
+} // namespace owl
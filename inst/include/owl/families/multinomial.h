@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../arma.h"
+#include "family.h"
+#include "../results.h"
+#include "../vectorMath.h"
+
+namespace owl {
+
+class Multinomial : public Family {
+public:
+  template <typename... Ts>
+  Multinomial(Ts... args) : Family(std::forward<Ts>(args)...) {}
+
+  // y holds the class labels 0, ..., m, where m (the number of columns of
+  // lin_pred) is the reference class, so the kernels index the column of
+  // the true class directly instead of using a one-hot matrix
+
+  double primal(const mat& y, const mat& lin_pred) const
+  {
+    const uword m = lin_pred.n_cols;
+
+    vec out = logSumExp(lin_pred);
+
+    for (uword i = 0; i < y.n_rows; ++i) {
+      const uword label = y(i);
+
+      if (label < m)
+        out(i) -= lin_pred(i, label);
+    }
+
+    return accu(weigh(out));
+  }
+
+  double dual(const mat& y, const mat& lin_pred) const
+  {
+    vec lse = logSumExp(lin_pred);
+
+    mat prob = fastExp(lin_pred.each_col() - lse);
+
+    return accu(weigh(lse - sum(lin_pred % prob, 1)));
+  }
+
+  mat pseudoGradient(const mat& y, const mat& lin_pred) const
+  {
+    const uword m = lin_pred.n_cols;
+
+    mat out = fastExp(lin_pred.each_col() - logSumExp(lin_pred));
+
+    for (uword i = 0; i < y.n_rows; ++i) {
+      const uword label = y(i);
+
+      if (label < m)
+        out(i, label) -= 1;
+    }
+
+    return weigh(out);
+  }
+
+  rowvec fitNullModel(const mat& y, const uword n_classes)
+  {
+    const uword m = n_classes - 1;
+
+    rowvec mu(m, fill::zeros);
+
+    for (uword i = 0; i < y.n_rows; ++i) {
+      const uword label = y(i);
+
+      if (label < m)
+        mu(label) += 1;
+    }
+
+    mu /= y.n_rows;
+
+    rowvec log_mu = trunc_log(mu);
+
+    return log_mu - accu(log_mu + trunc_log(1 - accu(mu)))/(m + 1);
+  }
+
+  std::string name()
+  {
+    return "multinomial";
+  }
+};
+
+} // namespace owl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../arma.h"
+#include "family.h"
+#include "../results.h"
+#include "../vectorMath.h"
+
+namespace owl {
+
+class Poisson : public Family {
+public:
+  template <typename... Ts>
+  Poisson(const mat& y, Ts... args)
+    : Family(std::forward<Ts>(args)...),
+      log_factorial(lgamma(y + 1)) {}
+
+  double primal(const mat& y, const mat& lin_pred) const
+  {
+    return -accu(weigh(y % lin_pred - fastExp(lin_pred) - log_factorial));
+  }
+
+  double dual(const mat& y, const mat& lin_pred) const
+  {
+    return -accu(weigh(fastExp(lin_pred) % (lin_pred - 1) - log_factorial));
+  }
+
+  mat pseudoGradient(const mat& y, const mat& lin_pred) const
+  {
+    return weigh(fastExp(lin_pred) - y);
+  }
+
+  rowvec fitNullModel(const mat& y, const uword n_classes)
+  {
+    return trunc_log(mean(y));
+  }
+
+  std::string name()
+  {
+    return "poisson";
+  }
+
+private:
+  // log(y!) for the response that the family is set up for, which is the
+  // same for every primal and dual along a path
+  const mat log_factorial;
+};
+
+} // namespace owl
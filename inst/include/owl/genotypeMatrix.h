@@ -0,0 +1,274 @@
+#pragma once
+
+#include "arma.h"
+#include <stdexcept>
+#include <vector>
+#include "columnStatistics.h"
+#include "products.h"
+
+namespace owl {
+
+// Decoding tables for bytes of four packed genotypes, where genotype t of a
+// byte is stored in bits 2t and 2t + 1.
+struct GenotypeTable {
+  unsigned char codes[256][4];
+  double values[256][4];
+
+  GenotypeTable()
+  {
+    for (int b = 0; b < 256; ++b) {
+      for (int t = 0; t < 4; ++t) {
+        codes[b][t] = (b >> (2*t)) & 3;
+        values[b][t] = codes[b][t];
+      }
+    }
+  }
+};
+
+inline const GenotypeTable& genotypeTable()
+{
+  static const GenotypeTable table;
+  return table;
+}
+
+// A matrix of genotypes (0, 1, or 2), packed into two bits per entry and
+// stored column by column with each column padded to a whole number of bytes.
+// The packed data is either borrowed (from R) or owned (for subsets).
+class GenotypeMatrix {
+public:
+  std::vector<unsigned char> owned;
+  const unsigned char* bytes = nullptr;
+  uword n_rows = 0;
+  uword n_cols = 0;
+  uword col_bytes = 0;
+
+  GenotypeMatrix(const unsigned char* bytes,
+                 const uword n_rows,
+                 const uword n_cols)
+    : bytes(bytes),
+      n_rows(n_rows),
+      n_cols(n_cols),
+      col_bytes((n_rows + 3)/4) {}
+
+  GenotypeMatrix(std::vector<unsigned char>&& data,
+                 const uword n_rows,
+                 const uword n_cols)
+    : owned(std::move(data)),
+      bytes(owned.data()),
+      n_rows(n_rows),
+      n_cols(n_cols),
+      col_bytes((n_rows + 3)/4) {}
+
+  // bytes may point into owned, so copies are not allowed
+  GenotypeMatrix(const GenotypeMatrix&) = delete;
+  GenotypeMatrix(GenotypeMatrix&&) = default;
+
+  const unsigned char* colptr(const uword j) const
+  {
+    return bytes + j*col_bytes;
+  }
+
+  // the total weight of the observations with genotype 1 and 2 in column j
+  void counts(const uword j,
+              const double* w,
+              double& w_ones,
+              double& w_twos) const
+  {
+    const GenotypeTable& table = genotypeTable();
+    const unsigned char* col = colptr(j);
+
+    w_ones = 0.0;
+    w_twos = 0.0;
+
+    for (uword i = 0; i < n_rows; ++i) {
+      const unsigned char code = table.codes[col[i/4]][i % 4];
+      w_ones += code == 1 ? w[i] : 0.0;
+      w_twos += code == 2 ? w[i] : 0.0;
+    }
+  }
+
+  // dot product of column j with a dense vector
+  double dot(const uword j, const double* r) const
+  {
+    const GenotypeTable& table = genotypeTable();
+    const unsigned char* col = colptr(j);
+    const uword full_bytes = n_rows/4;
+
+    double out = 0.0;
+
+    for (uword b = 0; b < full_bytes; ++b) {
+      const double* values = table.values[col[b]];
+      const double* r_b = r + 4*b;
+
+      out += values[0]*r_b[0] + values[1]*r_b[1]
+             + values[2]*r_b[2] + values[3]*r_b[3];
+    }
+
+    for (uword i = 4*full_bytes; i < n_rows; ++i)
+      out += table.values[col[full_bytes]][i - 4*full_bytes]*r[i];
+
+    return out;
+  }
+
+  // out += a*(column j)
+  void addColumn(const uword j, const double a, double* out) const
+  {
+    const GenotypeTable& table = genotypeTable();
+    const unsigned char* col = colptr(j);
+    const uword full_bytes = n_rows/4;
+    const double scaled[4] = {0.0, a, 2*a, 0.0};
+
+    for (uword b = 0; b < full_bytes; ++b) {
+      const unsigned char* codes = table.codes[col[b]];
+      double* out_b = out + 4*b;
+
+      out_b[0] += scaled[codes[0]];
+      out_b[1] += scaled[codes[1]];
+      out_b[2] += scaled[codes[2]];
+      out_b[3] += scaled[codes[3]];
+    }
+
+    for (uword i = 4*full_bytes; i < n_rows; ++i)
+      out[i] += scaled[table.codes[col[full_bytes]][i - 4*full_bytes]];
+  }
+
+  // decode a set of columns into a dense matrix
+  mat decode(const uvec& cols) const
+  {
+    mat out(n_rows, cols.n_elem, fill::zeros);
+
+    for (uword j = 0; j < cols.n_elem; ++j)
+      addColumn(cols(j), 1.0, out.colptr(j));
+
+    return out;
+  }
+};
+
+inline mat matrixProduct(const GenotypeMatrix& x, const mat& b)
+{
+  mat out(x.n_rows, b.n_cols, fill::zeros);
+
+  for (uword k = 0; k < b.n_cols; ++k)
+    for (uword j = 0; j < x.n_cols; ++j)
+      if (b(j, k) != 0.0)
+        x.addColumn(j, b(j, k), out.colptr(k));
+
+  return out;
+}
+
+inline mat matrixCrossProduct(const GenotypeMatrix& x, const mat& r)
+{
+  mat out(x.n_cols, r.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (uword j = 0; j < x.n_cols; ++j)
+    for (uword k = 0; k < r.n_cols; ++k)
+      out(j, k) = x.dot(j, r.colptr(k));
+
+  return out;
+}
+
+// the Gram matrices are only formed when the full problem is factorized
+// (without screening), so the columns are simply decoded
+inline mat matrixGram(const GenotypeMatrix& x)
+{
+  const mat x_dense = x.decode(regspace<uvec>(0, x.n_cols - 1));
+  return x_dense.t()*x_dense;
+}
+
+inline mat matrixOuterGram(const GenotypeMatrix& x, const rowvec& w)
+{
+  return matrixOuterGram(x.decode(regspace<uvec>(0, x.n_cols - 1)), w);
+}
+
+inline rowvec columnSums(const GenotypeMatrix& x)
+{
+  const vec ones_n(x.n_rows, fill::ones);
+  rowvec sums(x.n_cols);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    sums(j) = x.dot(j, ones_n.memptr());
+
+  return sums;
+}
+
+// all statistics except the cross product follow from the (weighted)
+// genotype counts
+inline ColumnStatistics columnStatistics(const GenotypeMatrix& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  const uword p = x.n_cols;
+  const uword m = r.n_cols;
+
+  ColumnStatistics stats(p, m, accu(w));
+
+  const mat r_w = weightedResponse(r, w);
+  stats.r_sums = sum(r_w, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (uword j = 0; j < p; ++j) {
+    double w_ones, w_twos;
+    x.counts(j, w.memptr(), w_ones, w_twos);
+
+    const double w_zeros = stats.n_obs - w_ones - w_twos;
+    const double s1 = w_ones + 2.0*w_twos;
+    const double s2 = w_ones + 4.0*w_twos;
+    const double x_max = w_twos > 0 ? 2.0 : (w_ones > 0 ? 1.0 : 0.0);
+
+    for (uword k = 0; k < m; ++k)
+      stats.xtr(j, k) = x.dot(j, r_w.colptr(k));
+
+    stats.setMoments(j, s1, s2, x_max, center);
+
+    if (l1) {
+      const double c = stats.center(j);
+
+      stats.l1(j) = w_zeros*std::abs(c)
+                    + w_ones*std::abs(1 - c)
+                    + w_twos*std::abs(2 - c);
+    }
+  }
+
+  return stats;
+}
+
+// subsets stay packed
+inline GenotypeMatrix matrixSubset(const GenotypeMatrix& x,
+                                   const uvec& active_set)
+{
+  std::vector<unsigned char> data(x.col_bytes*active_set.n_elem);
+
+  for (uword j = 0; j < active_set.n_elem; ++j)
+    std::copy(x.colptr(active_set(j)),
+              x.colptr(active_set(j)) + x.col_bytes,
+              data.begin() + j*x.col_bytes);
+
+  return GenotypeMatrix(std::move(data), x.n_rows, active_set.n_elem);
+}
+
+// pack a matrix of genotypes, each of which must be 0, 1, or 2
+inline std::vector<unsigned char> packGenotypes(const int* x,
+                                                const uword n_rows,
+                                                const uword n_cols)
+{
+  const uword col_bytes = (n_rows + 3)/4;
+  std::vector<unsigned char> data(col_bytes*n_cols, 0);
+
+  for (uword j = 0; j < n_cols; ++j) {
+    for (uword i = 0; i < n_rows; ++i) {
+      const int g = x[j*n_rows + i];
+
+      if (g < 0 || g > 2)
+        throw std::invalid_argument("genotypes must be 0, 1, or 2");
+
+      data[j*col_bytes + i/4] |= g << (2*(i % 4));
+    }
+  }
+
+  return data;
+}
+
+} // namespace owl
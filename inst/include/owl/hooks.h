@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace owl {
+
+// How a fit reports its progress and learns that it should stop. The solvers
+// neither print nor check for interrupts themselves, so that they can be
+// used without R and run many at once in one process: each fit calls its own
+// hooks, which by default do nothing. The R bindings set hooks that print to
+// the console and check for user interrupts.
+struct FitHooks {
+  // receives each line of progress (without the newline), if verbosity > 0
+  std::function<void(const std::string&)> log;
+
+  // polled regularly; returning true cancels the fit
+  std::function<bool()> cancelled;
+};
+
+// thrown by a fit whose cancelled hook returned true
+class FitCancelled : public std::runtime_error {
+public:
+  FitCancelled() : std::runtime_error("the fit was cancelled") {}
+};
+
+inline void logLine(const FitHooks& hooks, const std::string& line)
+{
+  if (hooks.log)
+    hooks.log(line);
+}
+
+inline void checkCancelled(const FitHooks& hooks)
+{
+  if (hooks.cancelled && hooks.cancelled())
+    throw FitCancelled();
+}
+
+} // namespace owl
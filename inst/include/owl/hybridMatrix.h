@@ -0,0 +1,170 @@
+#pragma once
+
+#include "arma.h"
+#include "columnStatistics.h"
+#include "products.h"
+#include "utils.h"
+#include <utility>
+
+namespace owl {
+
+// columns with a larger fraction of nonzeros than this are stored densely
+const double dense_column_density = 0.5;
+
+// A matrix whose columns are split into a dense block and a sparse (CSC)
+// block, so that each part is handled by the kernels best suited for it.
+// dense_cols and sparse_cols give the positions of the columns of each block
+// among the columns of the full matrix.
+class HybridMatrix {
+public:
+  mat dense;
+  sp_mat sparse;
+  uvec dense_cols;
+  uvec sparse_cols;
+  uword n_rows = 0;
+  uword n_cols = 0;
+
+  HybridMatrix(mat&& dense,
+               sp_mat&& sparse,
+               const uvec& dense_cols,
+               const uvec& sparse_cols)
+    : dense(std::move(dense)),
+      sparse(std::move(sparse)),
+      dense_cols(dense_cols),
+      sparse_cols(sparse_cols),
+      n_rows(this->sparse.n_rows),
+      n_cols(dense_cols.n_elem + sparse_cols.n_elem) {}
+};
+
+// indicators for the columns of x that are dense enough to be stored densely
+inline uvec denseColumns(const sp_mat& x)
+{
+  x.sync();
+
+  const double n = x.n_rows;
+  uvec is_dense(x.n_cols);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    is_dense(j) = (x.col_ptrs[j + 1] - x.col_ptrs[j])/n > dense_column_density;
+
+  return is_dense;
+}
+
+// split the columns of a sparse matrix into blocks
+inline HybridMatrix hybridMatrix(const sp_mat& x, const uvec& is_dense)
+{
+  const uvec dense_cols = find(is_dense);
+  const uvec sparse_cols = find(is_dense == 0);
+
+  return HybridMatrix(mat(matrixSubset(x, dense_cols)),
+                      matrixSubset(x, sparse_cols),
+                      dense_cols,
+                      sparse_cols);
+}
+
+inline mat matrixProduct(const HybridMatrix& x, const mat& b)
+{
+  return matrixProduct(x.dense, b.rows(x.dense_cols))
+         + matrixProduct(x.sparse, b.rows(x.sparse_cols));
+}
+
+inline mat matrixCrossProduct(const HybridMatrix& x, const mat& r)
+{
+  mat out(x.n_cols, r.n_cols);
+
+  out.rows(x.dense_cols) = matrixCrossProduct(x.dense, r);
+  out.rows(x.sparse_cols) = matrixCrossProduct(x.sparse, r);
+
+  return out;
+}
+
+inline mat matrixGram(const HybridMatrix& x)
+{
+  mat g(x.n_cols, x.n_cols);
+
+  const mat dense_sparse = mat(x.sparse.t()*x.dense).t();
+
+  g.submat(x.dense_cols, x.dense_cols) = matrixGram(x.dense);
+  g.submat(x.dense_cols, x.sparse_cols) = dense_sparse;
+  g.submat(x.sparse_cols, x.dense_cols) = dense_sparse.t();
+  g.submat(x.sparse_cols, x.sparse_cols) = matrixGram(x.sparse);
+
+  return g;
+}
+
+inline mat matrixOuterGram(const HybridMatrix& x, const rowvec& w)
+{
+  return matrixOuterGram(x.dense, w.cols(x.dense_cols))
+         + matrixOuterGram(x.sparse, w.cols(x.sparse_cols));
+}
+
+inline rowvec columnSums(const HybridMatrix& x)
+{
+  rowvec sums(x.n_cols);
+
+  sums.cols(x.dense_cols) = columnSums(x.dense);
+  sums.cols(x.sparse_cols) = columnSums(x.sparse);
+
+  return sums;
+}
+
+inline ColumnStatistics columnStatistics(const HybridMatrix& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  const ColumnStatistics dense_stats =
+    columnStatistics(x.dense, r, w, center, l1);
+  const ColumnStatistics sparse_stats =
+    columnStatistics(x.sparse, r, w, center, l1);
+
+  ColumnStatistics stats(x.n_cols, r.n_cols, dense_stats.n_obs);
+  stats.r_sums = dense_stats.r_sums;
+
+  stats.center.cols(x.dense_cols) = dense_stats.center;
+  stats.center.cols(x.sparse_cols) = sparse_stats.center;
+  stats.l1.cols(x.dense_cols) = dense_stats.l1;
+  stats.l1.cols(x.sparse_cols) = sparse_stats.l1;
+  stats.l2.cols(x.dense_cols) = dense_stats.l2;
+  stats.l2.cols(x.sparse_cols) = sparse_stats.l2;
+  stats.sd.cols(x.dense_cols) = dense_stats.sd;
+  stats.sd.cols(x.sparse_cols) = sparse_stats.sd;
+  stats.max.cols(x.dense_cols) = dense_stats.max;
+  stats.max.cols(x.sparse_cols) = sparse_stats.max;
+  stats.xtr.rows(x.dense_cols) = dense_stats.xtr;
+  stats.xtr.rows(x.sparse_cols) = sparse_stats.xtr;
+
+  return stats;
+}
+
+inline HybridMatrix matrixSubset(const HybridMatrix& x,
+                                 const uvec& active_set)
+{
+  // which block, and where in it, each column is
+  uvec block(x.n_cols);
+  uvec index(x.n_cols);
+
+  for (uword j = 0; j < x.dense_cols.n_elem; ++j) {
+    block(x.dense_cols(j)) = 0;
+    index(x.dense_cols(j)) = j;
+  }
+
+  for (uword j = 0; j < x.sparse_cols.n_elem; ++j) {
+    block(x.sparse_cols(j)) = 1;
+    index(x.sparse_cols(j)) = j;
+  }
+
+  const uvec active_block = block.elem(active_set);
+  const uvec active_dense = find(active_block == 0);
+  const uvec active_sparse = find(active_block == 1);
+
+  const uvec subset_index = index.elem(active_set);
+
+  return HybridMatrix(matrixSubset(x.dense, subset_index(active_dense)),
+                      matrixSubset(x.sparse, subset_index(active_sparse)),
+                      active_dense,
+                      active_sparse);
+}
+
+} // namespace owl
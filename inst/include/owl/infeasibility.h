@@ -0,0 +1,14 @@
+#pragma once
+
+#include "arma.h"
+#include "sortedMagnitudes.h"
+
+namespace owl {
+
+inline double infeasibility(const SortedMagnitudes& gradient, const vec& lambda)
+{
+  vec infeas = gradient.excess(lambda);
+  return std::max(infeas.max(), 0.0);
+}
+
+} // namespace owl
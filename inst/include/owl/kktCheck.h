@@ -0,0 +1,63 @@
+#pragma once
+
+#include "arma.h"
+#include "sortedMagnitudes.h"
+#include "utils.h"
+
+namespace owl {
+
+// gradient holds the sorted magnitudes of the gradient, not including the
+// intercept
+inline uvec kktCheck(const SortedMagnitudes& gradient,
+                     mat          beta,
+                     const vec&   lambda,
+                     const double tol,
+                     const bool   intercept)
+{
+  if (intercept)
+    beta.shed_row(0);
+
+  uvec nonzeros = find(beta != 0);
+
+  double rh = std::max(std::sqrt(datum::eps), tol*lambda(0));
+
+  uvec tmp = gradient.excess(lambda) > rh;
+  tmp(gradient.order) = tmp;
+  tmp(nonzeros).zeros();
+
+  umat out_mat = reshape(tmp, gradient.n_rows, gradient.n_cols);
+
+  uvec out = find(any(out_mat, 1));
+
+  if (intercept)
+    out += 1;
+
+  return out;
+}
+
+// the predictors outside the active set that fail the KKT check, among the
+// strong set and among all predictors
+struct KktFailures {
+  uvec strong;
+  uvec all;
+};
+
+inline KktFailures kktFailures(const SortedMagnitudes& gradient,
+                               const mat&   beta,
+                               const vec&   lambda,
+                               const uvec&  strong_set,
+                               const uvec&  active_set,
+                               const double tol,
+                               const bool   intercept)
+{
+  const uvec possible_failures =
+    kktCheck(gradient, beta, lambda, tol, intercept);
+
+  KktFailures out;
+  out.strong = setDiff(intersect(possible_failures, strong_set), active_set);
+  out.all = setDiff(possible_failures, active_set);
+
+  return out;
+}
+
+} // namespace owl
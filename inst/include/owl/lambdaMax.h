@@ -0,0 +1,65 @@
+#pragma once
+
+#include "arma.h"
+#include "columnStatistics.h"
+#include "standardizedMatrix.h"
+
+namespace owl {
+
+// the weighted means of the columns of y
+inline rowvec weightedMean(const mat& y, const vec& w)
+{
+  return (w.t()*y)/accu(w);
+}
+
+// the response whose correlation with the predictors gives lambda_max, where
+// m is the number of targets (of non-reference classes for multinomial
+// models, which need not all appear in y)
+inline mat lambdaMaxResponse(const mat& y,
+                             const vec& w,
+                             const std::string& family,
+                             const uword m)
+{
+  if (family == "binomial") {
+    mat y_new = (y + 1)/2;
+    y_new.each_row() -= weightedMean(y_new, w);
+
+    return y_new;
+
+  } else if (family == "multinomial") {
+    // expand the class labels (only once, for the path setup), where the
+    // last class is the reference class
+    mat y_map(y.n_rows, m, fill::zeros);
+
+    for (uword i = 0; i < y.n_rows; ++i) {
+      const uword label = y(i);
+
+      if (label < m)
+        y_map(i, label) = 1;
+    }
+
+    y_map.each_row() -= weightedMean(y_map, w);
+
+    return y_map;
+
+  } else if (family == "poisson") {
+
+    return 1 - y;
+
+  }
+
+  return y;
+}
+
+// lambda_max from the cross product of the raw storage of x with the
+// response, which is computed along with the column statistics
+template <typename T>
+vec lambdaMax(const StandardizedMatrix<T>& x, const ColumnStatistics& stats)
+{
+  mat lambda_max = stats.xtr - x.center.t()*stats.r_sums;
+  lambda_max.each_col() /= x.scale.t();
+
+  return abs(vectorise(lambda_max));
+}
+
+} // namespace owl
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "arma.h"
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include "columnStatistics.h"
+#include "products.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace owl {
+
+// Read-only memory mapping of a file. Its pages are read from disk on demand
+// and can be evicted by the OS under memory pressure, so the file does not
+// need to fit in memory.
+class FileMapping {
+public:
+  const char* data = nullptr;
+  std::size_t size = 0;
+
+  FileMapping(const std::string& path)
+  {
+#ifdef _WIN32
+    throw std::runtime_error("memory-mapped predictors are not supported on Windows");
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd == -1)
+      throw std::runtime_error("could not open '" + path + "'");
+
+    struct stat info;
+
+    if (fstat(fd, &info) == -1) {
+      close(fd);
+      throw std::runtime_error("could not read the size of '" + path + "'");
+    }
+
+    size = info.st_size;
+
+    if (size > 0) {
+      void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if (ptr == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("could not map '" + path + "' into memory");
+      }
+
+      data = static_cast<const char*>(ptr);
+    }
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+#endif
+  }
+
+  ~FileMapping()
+  {
+#ifndef _WIN32
+    if (data)
+      munmap(const_cast<char*>(data), size);
+#endif
+  }
+
+  FileMapping(const FileMapping&) = delete;
+  FileMapping& operator=(const FileMapping&) = delete;
+};
+
+// A dense, column-major, matrix of doubles stored in a file. Products stream
+// through the columns of the mapping, whereas subsets of columns (the
+// screened subproblems) are copied into memory.
+class MappedDenseMatrix {
+public:
+  std::shared_ptr<const FileMapping> mapping;
+  const double* mem = nullptr;
+  uword n_rows = 0;
+  uword n_cols = 0;
+
+  MappedDenseMatrix(const std::string& path,
+                    const uword n_rows,
+                    const uword n_cols)
+    : mapping(std::make_shared<const FileMapping>(path)),
+      n_rows(n_rows),
+      n_cols(n_cols)
+  {
+    if (mapping->size != n_rows*n_cols*sizeof(double))
+      throw std::runtime_error("the size of '" + path + "' does not match its dimensions");
+
+    mem = reinterpret_cast<const double*>(mapping->data);
+  }
+
+  // a matrix using the mapped memory directly, which is never written to
+  mat view() const
+  {
+    return mat(const_cast<double*>(mem), n_rows, n_cols, false, true);
+  }
+};
+
+inline mat matrixProduct(const MappedDenseMatrix& x, const mat& b)
+{
+  return x.view()*b;
+}
+
+inline mat matrixCrossProduct(const MappedDenseMatrix& x, const mat& r)
+{
+  return x.view().t()*r;
+}
+
+inline mat matrixGram(const MappedDenseMatrix& x)
+{
+  const mat x_view = x.view();
+  return x_view.t()*x_view;
+}
+
+inline mat matrixOuterGram(const MappedDenseMatrix& x, const rowvec& w)
+{
+  return matrixOuterGram(x.view(), w);
+}
+
+inline rowvec columnSums(const MappedDenseMatrix& x)
+{
+  return sum(x.view(), 0);
+}
+
+inline ColumnStatistics columnStatistics(const MappedDenseMatrix& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  return columnStatistics(x.view(), r, w, center, l1);
+}
+
+inline mat matrixSubset(const MappedDenseMatrix& x, const uvec& active_set)
+{
+  const uword n = x.n_rows;
+  mat x_subset(n, active_set.n_elem);
+
+  for (uword j = 0; j < active_set.n_elem; ++j)
+    std::copy(x.mem + active_set(j)*n,
+              x.mem + (active_set(j) + 1)*n,
+              x_subset.colptr(j));
+
+  return x_subset;
+}
+
+// A sparse matrix stored in compressed sparse column format in a file, laid
+// out as the column pointers (p + 1 32-bit integers), the row indices (nnz
+// 32-bit integers), padding to a multiple of eight bytes, and the values (nnz
+// doubles), as in the slots of a dgCMatrix.
+class MappedSparseMatrix {
+public:
+  std::shared_ptr<const FileMapping> mapping;
+  const int* col_ptrs = nullptr;
+  const int* row_indices = nullptr;
+  const double* values = nullptr;
+  uword n_rows = 0;
+  uword n_cols = 0;
+  uword n_nonzero = 0;
+
+  MappedSparseMatrix(const std::string& path,
+                     const uword n_rows,
+                     const uword n_cols)
+    : mapping(std::make_shared<const FileMapping>(path)),
+      n_rows(n_rows),
+      n_cols(n_cols)
+  {
+    const std::size_t ptr_bytes = (n_cols + 1)*sizeof(int);
+
+    if (mapping->size < ptr_bytes)
+      throw std::runtime_error("the size of '" + path + "' does not match its dimensions");
+
+    col_ptrs = reinterpret_cast<const int*>(mapping->data);
+
+    if (col_ptrs[n_cols] < 0)
+      throw std::runtime_error("the column pointers in '" + path + "' are invalid");
+
+    n_nonzero = col_ptrs[n_cols];
+
+    std::size_t index_bytes = ptr_bytes + n_nonzero*sizeof(int);
+    index_bytes += index_bytes % sizeof(double);
+
+    if (mapping->size != index_bytes + n_nonzero*sizeof(double))
+      throw std::runtime_error("the size of '" + path + "' does not match its dimensions");
+
+    row_indices = col_ptrs + n_cols + 1;
+    values = reinterpret_cast<const double*>(mapping->data + index_bytes);
+
+    // the products index by the row indices without checks, so the structure
+    // is checked once here
+    if (col_ptrs[0] != 0)
+      throw std::runtime_error("the column pointers in '" + path + "' are invalid");
+
+    for (uword j = 0; j < n_cols; ++j) {
+      if (col_ptrs[j + 1] < col_ptrs[j])
+        throw std::runtime_error("the column pointers in '" + path + "' are invalid");
+    }
+
+    for (uword ind = 0; ind < n_nonzero; ++ind) {
+      if (row_indices[ind] < 0 || static_cast<uword>(row_indices[ind]) >= n_rows)
+        throw std::runtime_error("the row indices in '" + path + "' are out of bounds");
+    }
+  }
+
+  // copy a subset of the columns into memory
+  sp_mat load(const uvec& cols) const
+  {
+    uvec subset_ptrs(cols.n_elem + 1);
+    subset_ptrs(0) = 0;
+
+    for (uword j = 0; j < cols.n_elem; ++j)
+      subset_ptrs(j + 1) =
+        subset_ptrs(j) + col_ptrs[cols(j) + 1] - col_ptrs[cols(j)];
+
+    uvec subset_rows(subset_ptrs(cols.n_elem));
+    vec subset_values(subset_ptrs(cols.n_elem));
+
+    for (uword j = 0; j < cols.n_elem; ++j) {
+      const uword start = col_ptrs[cols(j)];
+      const uword end = col_ptrs[cols(j) + 1];
+
+      for (uword ind = start; ind < end; ++ind) {
+        subset_rows(subset_ptrs(j) + ind - start) = row_indices[ind];
+        subset_values(subset_ptrs(j) + ind - start) = values[ind];
+      }
+    }
+
+    return sp_mat(subset_rows,
+                  subset_ptrs,
+                  subset_values,
+                  n_rows,
+                  cols.n_elem);
+  }
+};
+
+inline mat matrixProduct(const MappedSparseMatrix& x, const mat& b)
+{
+  return cscProduct(x.col_ptrs,
+                    x.row_indices,
+                    x.values,
+                    x.n_rows,
+                    x.n_cols,
+                    b);
+}
+
+inline mat matrixCrossProduct(const MappedSparseMatrix& x, const mat& r)
+{
+  return cscCrossProduct(x.col_ptrs, x.row_indices, x.values, x.n_cols, r);
+}
+
+// the Gram matrices are only formed when the full problem is factorized
+// (without screening), in which case all of x has to be in memory anyway
+inline mat matrixGram(const MappedSparseMatrix& x)
+{
+  return matrixGram(x.load(regspace<uvec>(0, x.n_cols - 1)));
+}
+
+inline mat matrixOuterGram(const MappedSparseMatrix& x, const rowvec& w)
+{
+  return matrixOuterGram(x.load(regspace<uvec>(0, x.n_cols - 1)), w);
+}
+
+inline rowvec columnSums(const MappedSparseMatrix& x)
+{
+  rowvec sums(x.n_cols, fill::zeros);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    for (int ind = x.col_ptrs[j]; ind < x.col_ptrs[j + 1]; ++ind)
+      sums(j) += x.values[ind];
+
+  return sums;
+}
+
+inline ColumnStatistics columnStatistics(const MappedSparseMatrix& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  return cscColumnStatistics(x.col_ptrs,
+                             x.row_indices,
+                             x.values,
+                             x.n_rows,
+                             x.n_cols,
+                             r,
+                             w,
+                             center,
+                             l1);
+}
+
+inline sp_mat matrixSubset(const MappedSparseMatrix& x,
+                           const uvec& active_set)
+{
+  return x.load(active_set);
+}
+
+} // namespace owl
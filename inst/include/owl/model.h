@@ -0,0 +1,340 @@
+#pragma once
+
+// Binary format for fitted owl models, which is read and written without R
+// so that scoring services can memory map a model and predict from it
+// directly, without parsing or copying it.
+//
+// A model file consists of a fixed-size header followed by arrays of 8-byte
+// elements (so every array is aligned to 8 bytes), in native byte order:
+//
+//   double   sigma[n_sigma]
+//   double   lambda[n_lambda]
+//   double   x_center[n_rows]
+//   double   x_scale[n_rows]
+//   uint64_t col_ptrs[n_targets*n_sigma + 1]
+//   uint64_t row_indices[n_nonzero]
+//   double   values[n_nonzero]
+//
+// The coefficients (on the original scale of the predictors) form a sparse
+// n_rows by n_targets*n_sigma matrix in compressed sparse column format,
+// with the columns for the n_targets targets of each sigma next to each other
+// and the intercept (if any) in the first row. The header stores the offset
+// of each array from the start of the file.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace owl {
+
+const char model_magic[8] = {'O', 'W', 'L', 'M', 'O', 'D', 'E', 'L'};
+const std::uint32_t model_version = 1;
+
+enum class ModelFamily : std::uint32_t {
+  gaussian = 0,
+  binomial = 1,
+  multinomial = 2,
+  poisson = 3
+};
+
+struct ModelHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t family;
+  std::uint32_t intercept;
+  // 1, written in native byte order, to detect files from other platforms
+  std::uint32_t byte_order;
+  std::uint64_t n_rows;
+  std::uint64_t n_targets;
+  std::uint64_t n_sigma;
+  std::uint64_t n_lambda;
+  std::uint64_t n_nonzero;
+  std::uint64_t sigma_offset;
+  std::uint64_t lambda_offset;
+  std::uint64_t center_offset;
+  std::uint64_t scale_offset;
+  std::uint64_t col_ptrs_offset;
+  std::uint64_t row_indices_offset;
+  std::uint64_t values_offset;
+  std::uint64_t file_size;
+};
+
+static_assert(sizeof(ModelHeader) % 8 == 0,
+              "the model header must keep the arrays aligned");
+
+// The contents of a model, which point either into a mapped file or into
+// memory owned by the caller.
+struct ModelView {
+  ModelFamily family = ModelFamily::gaussian;
+  bool intercept = false;
+  std::uint64_t n_rows = 0;
+  std::uint64_t n_targets = 0;
+  std::uint64_t n_sigma = 0;
+  std::uint64_t n_lambda = 0;
+  std::uint64_t n_nonzero = 0;
+  const double* sigma = nullptr;
+  const double* lambda = nullptr;
+  const double* x_center = nullptr;
+  const double* x_scale = nullptr;
+  const std::uint64_t* col_ptrs = nullptr;
+  const std::uint64_t* row_indices = nullptr;
+  const double* values = nullptr;
+
+  // The linear predictors, for each target, of an observation with the
+  // (dense) predictors x at the k:th sigma.
+  void linearPredictor(const double* x, std::uint64_t k, double* out) const
+  {
+    const std::uint64_t offset = intercept ? 1 : 0;
+
+    for (std::uint64_t t = 0; t < n_targets; ++t) {
+      const std::uint64_t col = k*n_targets + t;
+      double eta = 0.0;
+
+      for (std::uint64_t ind = col_ptrs[col]; ind < col_ptrs[col + 1]; ++ind) {
+        const std::uint64_t j = row_indices[ind];
+        eta += j < offset ? values[ind] : x[j - offset]*values[ind];
+      }
+
+      out[t] = eta;
+    }
+  }
+};
+
+// check the header and set up a view of a model stored at data
+inline ModelView viewModel(const char* data, const std::uint64_t size)
+{
+  ModelHeader header;
+
+  if (size < sizeof(header))
+    throw std::runtime_error("the model file is truncated");
+
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(header.magic, model_magic, sizeof(model_magic)) != 0)
+    throw std::runtime_error("not an owl model file");
+
+  if (header.byte_order != 1)
+    throw std::runtime_error("the model file has the wrong byte order");
+
+  if (header.version != model_version)
+    throw std::runtime_error("unsupported model file version "
+                             + std::to_string(header.version));
+
+  if (header.file_size != size)
+    throw std::runtime_error("the model file is truncated");
+
+  if (header.family > static_cast<std::uint32_t>(ModelFamily::poisson))
+    throw std::runtime_error("the model file has an unknown family");
+
+  // does an array of n 8-byte elements at offset lie (aligned) within the
+  // file? (written so that none of the sizes can overflow)
+  auto fits = [size](const std::uint64_t offset, const std::uint64_t n) {
+    return offset >= sizeof(ModelHeader)
+      && offset % 8 == 0
+      && offset <= size
+      && n <= (size - offset)/8;
+  };
+
+  if (header.n_sigma > 0 && header.n_targets > (size/8)/header.n_sigma)
+    throw std::runtime_error("the model file is corrupt");
+
+  const std::uint64_t n_cols = header.n_targets*header.n_sigma;
+
+  if (!fits(header.sigma_offset, header.n_sigma)
+      || !fits(header.lambda_offset, header.n_lambda)
+      || !fits(header.center_offset, header.n_rows)
+      || !fits(header.scale_offset, header.n_rows)
+      || !fits(header.col_ptrs_offset, n_cols + 1)
+      || !fits(header.row_indices_offset, header.n_nonzero)
+      || !fits(header.values_offset, header.n_nonzero)
+      || header.values_offset + 8*header.n_nonzero != size)
+    throw std::runtime_error("the model file is truncated");
+
+  // the coefficients are read without bounds checks when predicting, so
+  // their structure is checked here
+  const std::uint64_t* col_ptrs =
+    reinterpret_cast<const std::uint64_t*>(data + header.col_ptrs_offset);
+  const std::uint64_t* row_indices =
+    reinterpret_cast<const std::uint64_t*>(data + header.row_indices_offset);
+
+  if (col_ptrs[0] != 0 || col_ptrs[n_cols] != header.n_nonzero)
+    throw std::runtime_error("the model file is corrupt");
+
+  for (std::uint64_t j = 0; j < n_cols; ++j) {
+    if (col_ptrs[j + 1] < col_ptrs[j])
+      throw std::runtime_error("the model file is corrupt");
+  }
+
+  for (std::uint64_t ind = 0; ind < header.n_nonzero; ++ind) {
+    if (row_indices[ind] >= header.n_rows)
+      throw std::runtime_error("the model file is corrupt");
+  }
+
+  ModelView model;
+  model.family = static_cast<ModelFamily>(header.family);
+  model.intercept = header.intercept != 0;
+  model.n_rows = header.n_rows;
+  model.n_targets = header.n_targets;
+  model.n_sigma = header.n_sigma;
+  model.n_lambda = header.n_lambda;
+  model.n_nonzero = header.n_nonzero;
+  model.sigma =
+    reinterpret_cast<const double*>(data + header.sigma_offset);
+  model.lambda =
+    reinterpret_cast<const double*>(data + header.lambda_offset);
+  model.x_center =
+    reinterpret_cast<const double*>(data + header.center_offset);
+  model.x_scale =
+    reinterpret_cast<const double*>(data + header.scale_offset);
+  model.col_ptrs = col_ptrs;
+  model.row_indices = row_indices;
+  model.values =
+    reinterpret_cast<const double*>(data + header.values_offset);
+
+  return model;
+}
+
+// A model file mapped (read-only) into memory.
+class MappedModel {
+public:
+  ModelView model;
+
+  explicit MappedModel(const std::string& path)
+  {
+#ifdef _WIN32
+    throw std::runtime_error("mapped models are not supported on Windows");
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd == -1)
+      throw std::runtime_error("could not open '" + path + "'");
+
+    struct stat info;
+
+    if (fstat(fd, &info) == -1) {
+      close(fd);
+      throw std::runtime_error("could not read the size of '" + path + "'");
+    }
+
+    size = info.st_size;
+
+    void* ptr =
+      size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+
+    close(fd);
+
+    if (ptr == MAP_FAILED || ptr == nullptr)
+      throw std::runtime_error("could not map '" + path + "' into memory");
+
+    data = static_cast<const char*>(ptr);
+
+    try {
+      model = viewModel(data, size);
+    } catch (...) {
+      munmap(const_cast<char*>(data), size);
+      throw;
+    }
+#endif
+  }
+
+  ~MappedModel()
+  {
+#ifndef _WIN32
+    if (data)
+      munmap(const_cast<char*>(data), size);
+#endif
+  }
+
+  MappedModel(const MappedModel&) = delete;
+  MappedModel& operator=(const MappedModel&) = delete;
+
+private:
+  const char* data = nullptr;
+  std::size_t size = 0;
+};
+
+// Write a model to path. The sparse coefficients are given by col_ptrs
+// (n_targets*n_sigma + 1 of them), row_indices, and values.
+inline void writeModel(const std::string& path,
+                       const ModelFamily family,
+                       const bool intercept,
+                       const std::uint64_t n_rows,
+                       const std::uint64_t n_targets,
+                       const std::vector<double>& sigma,
+                       const std::vector<double>& lambda,
+                       const std::vector<double>& x_center,
+                       const std::vector<double>& x_scale,
+                       const std::vector<std::uint64_t>& col_ptrs,
+                       const std::vector<std::uint64_t>& row_indices,
+                       const std::vector<double>& values)
+{
+  const std::uint64_t n_sigma = sigma.size();
+
+  if (col_ptrs.size() != n_targets*n_sigma + 1
+      || row_indices.size() != values.size()
+      || x_center.size() != n_rows
+      || x_scale.size() != n_rows)
+    throw std::invalid_argument("inconsistent dimensions of the model");
+
+  ModelHeader header = {};
+  std::memcpy(header.magic, model_magic, sizeof(model_magic));
+  header.version = model_version;
+  header.family = static_cast<std::uint32_t>(family);
+  header.intercept = intercept;
+  header.byte_order = 1;
+  header.n_rows = n_rows;
+  header.n_targets = n_targets;
+  header.n_sigma = n_sigma;
+  header.n_lambda = lambda.size();
+  header.n_nonzero = values.size();
+
+  std::uint64_t offset = sizeof(header);
+
+  auto place = [&offset](std::uint64_t& array_offset, std::uint64_t n) {
+    array_offset = offset;
+    offset += 8*n;
+  };
+
+  place(header.sigma_offset, n_sigma);
+  place(header.lambda_offset, lambda.size());
+  place(header.center_offset, n_rows);
+  place(header.scale_offset, n_rows);
+  place(header.col_ptrs_offset, col_ptrs.size());
+  place(header.row_indices_offset, row_indices.size());
+  place(header.values_offset, values.size());
+
+  header.file_size = offset;
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+  if (!out)
+    throw std::runtime_error("could not open '" + path + "' for writing");
+
+  auto write = [&out](const void* src, std::uint64_t bytes) {
+    out.write(static_cast<const char*>(src), bytes);
+  };
+
+  write(&header, sizeof(header));
+  write(sigma.data(), 8*sigma.size());
+  write(lambda.data(), 8*lambda.size());
+  write(x_center.data(), 8*x_center.size());
+  write(x_scale.data(), 8*x_scale.size());
+  write(col_ptrs.data(), 8*col_ptrs.size());
+  write(row_indices.data(), 8*row_indices.size());
+  write(values.data(), 8*values.size());
+
+  if (!out)
+    throw std::runtime_error("could not write the model to '" + path + "'");
+}
+
+} // namespace owl
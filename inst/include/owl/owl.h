@@ -0,0 +1,21 @@
+#pragma once
+
+// The core of owl: the solvers, the regularization path, cross-validation,
+// and prediction, along with the storage types for the predictor matrix.
+// It depends on Armadillo (and, optionally, OpenMP) but not on R, and lives
+// in the owl namespace, so that other C++ code can fit and score models by
+// including this header (with inst/include on the include path).
+
+#include "compressRows.h"
+#include "crossValidation.h"
+#include "genotypeMatrix.h"
+#include "hooks.h"
+#include "hybridMatrix.h"
+#include "mappedMatrix.h"
+#include "model.h"
+#include "path.h"
+#include "patternMatrix.h"
+#include "predict.h"
+#include "prox.h"
+#include "standardizedMatrix.h"
+#include "threads.h"
@@ -0,0 +1,1075 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "results.h"
+#include "families/families.h"
+#include "screening.h"
+#include "standardizedMatrix.h"
+#include "pruneColumns.h"
+#include "hooks.h"
+#include "consensus.h"
+#include "standardize.h"
+#include "rescale.h"
+#include "regularizationPath.h"
+#include "kktCheck.h"
+#include "threads.h"
+
+namespace owl {
+
+// The solver state at the last point along a path, from which the path can
+// be continued
+struct PathState {
+  rowvec x_center;
+  rowvec x_scale;
+  vec lambda;
+  double sigma_max = 0.0;
+  double sigma = 0.0;
+  mat beta;
+  vec z;
+  vec u;
+  uvec ever_active_set;
+  double null_deviance = 0.0;
+};
+
+// The settings of a path fit (see the control list in owl())
+struct PathSettings {
+  std::string family;
+  bool intercept = true;
+  bool center = true;
+  std::string scale = "l2";
+  uword n_targets = 1;
+  bool screening = true;
+  bool adaptive = false;
+  double tol_adaptive = 1e-2;
+  vec sigma;
+  std::string sigma_type = "auto";
+  vec lambda;
+  std::string lambda_type = "gaussian";
+  double lambda_min_ratio = 1e-4;
+  // the shapes of the lambda sequences, one path for each
+  vec q;
+  rowvec y_center;
+  rowvec y_scale;
+  uword max_passes = 1e6;
+  double max_time = datum::inf;
+  bool diagnostics = false;
+  uword verbosity = 0;
+  uword max_variables = 0;
+  double tol_dev_change = 1e-5;
+  double tol_dev_ratio = 0.995;
+  double tol_rel_gap = 1e-5;
+  double tol_infeas = 1e-3;
+  double tol_abs = 1e-5;
+  double tol_rel = 1e-4;
+
+  // the number of worker processes for consensus ADMM over shards of the
+  // observations, which is not used if it is 1
+  uword n_shards = 1;
+
+  // the program and arguments that start a shard worker, which are followed
+  // by its end of the socket to the coordinator (see ConsensusADMM)
+  std::vector<std::string> shard_worker;
+
+  // verify the KKT conditions at each point on another thread while the
+  // next point is fit from the tentative solution (only with screening and
+  // not for adaptive paths)
+  bool pipelined = false;
+
+  // may the storage of x be replaced by a pruned copy? (not if it is shared
+  // with other fits)
+  bool rebuild_storage = true;
+
+  // continue from state?
+  bool resume = false;
+  PathState state;
+
+  // logging and cancellation, which are left out by default
+  FitHooks hooks;
+};
+
+// A fitted path, with the coefficients on the original scale
+struct PathFit {
+  sp_mat coefficients;
+  field<uvec> active_sets;
+  uvec passes;
+  std::vector<std::vector<double>> primals;
+  std::vector<std::vector<double>> duals;
+  std::vector<std::vector<double>> time;
+  uvec n_unique;
+  std::vector<std::vector<unsigned>> violations;
+  vec deviance_ratio;
+  double null_deviance = 0.0;
+  std::vector<bool> interpolated;
+  std::vector<bool> converged;
+  bool timed_out = false;
+  PathState state;
+  vec sigma;
+  vec lambda;
+};
+
+// The parts of a fit that do not depend on the lambda sequence, which are
+// shared by the paths for several q
+struct PathSetup {
+  // the standardization, including the intercept
+  rowvec x_center;
+  rowvec x_scale;
+
+  // the (non-intercept) columns of the original problem that each column
+  // left in the problem stands for
+  ColumnGroups groups;
+  uword p_full = 0;
+
+  // the end of the time budget for all of the paths
+  std::chrono::steady_clock::time_point deadline;
+
+  // for ADMM: x'y and the Gram matrix of the full problem (or x*x' if x is
+  // wide) with its largest eigenvalue, which are computed by the first path
+  // that needs them
+  vec xTy;
+  mat gram;
+  double gram_eigenvalue = 0.0;
+};
+
+// The penalty along one path
+struct PathPenalty {
+  vec sigma;
+  vec lambda;
+  double sigma_max = 0.0;
+
+  // the sigma that the first point is warm-started from
+  double sigma_start = 0.0;
+};
+
+// the gradient at the tentative solution beta for a point along the path,
+// with its sorted magnitudes and the failures of the KKT check there
+struct PointCheck {
+  mat beta;
+  mat gradient;
+  SortedMagnitudes sorted_gradient;
+  KktFailures failures;
+};
+
+// the part of the path state that fitting a point changes, which is set
+// aside for the previous point while the next is fit speculatively
+struct PointState {
+  mat beta;
+  uvec active_set;
+  uvec ever_active_set;
+  vec z;
+  vec u;
+  Results res;
+};
+
+// Fit the path for the penalty, after the setup of x by fitPaths(). This
+// does not use the R API (progress and cancellation go through
+// settings.hooks), so that paths can be fit on worker threads.
+template <typename T>
+PathFit fitPath(const StandardizedMatrix<T>& x,
+                const mat& y,
+                const vec& weights,
+                const PathSettings& settings,
+                PathSetup& setup,
+                const PathPenalty& penalty,
+                const sp_mat& warm_start)
+{
+  using std::setw;
+  using std::showpoint;
+
+  const double tol_dev_ratio = settings.tol_dev_ratio;
+  const double tol_dev_change = settings.tol_dev_change;
+  const uword max_variables = settings.max_variables;
+
+  const bool diagnostics = settings.diagnostics;
+  const uword verbosity = settings.verbosity;
+  const FitHooks& hooks = settings.hooks;
+
+  const double tol_infeas = settings.tol_infeas;
+
+  const std::string& family_choice = settings.family;
+  const bool intercept = settings.intercept;
+  const bool adaptive = settings.adaptive;
+  const double tol_adaptive = settings.tol_adaptive;
+
+  // fit with consensus ADMM over shards of the observations, which are
+  // always fit in full (without screening)?
+  const bool sharded = settings.n_shards > 1;
+  bool screening = settings.screening && !sharded;
+
+  // the ADMM solver for the gaussian family only handles unit weights
+  const bool admm =
+    family_choice == "gaussian" && all(weights == 1) && !sharded;
+
+  const auto n = x.n_rows;
+  const auto p = x.n_cols;
+  const uword p_full = setup.p_full;
+  // the number of targets, which for multinomial models (where y holds the
+  // class labels) is not the number of columns of y
+  const uword m = settings.n_targets;
+
+  const rowvec& x_center = setup.x_center;
+  const rowvec& x_scale = setup.x_scale;
+  const ColumnGroups& groups = setup.groups;
+
+  // the number of columns of the original problem that each row stands for
+  const vec row_copies = rowCopies(groups, intercept);
+
+  // continue the path from the solver state of a previous fit?
+  const bool resume = settings.resume;
+  const PathState& state = settings.state;
+
+  vec sigma = penalty.sigma;
+  const uword n_sigma = sigma.n_elem;
+  const double sigma_max = penalty.sigma_max;
+  const double sigma_start = penalty.sigma_start;
+
+  const vec& lambda_full = penalty.lambda;
+  const vec lambda = lambda_full.head(groups.members.n_elem*m);
+
+  auto family = setupFamily(family_choice,
+                            y,
+                            intercept,
+                            diagnostics,
+                            settings.max_passes,
+                            settings.tol_rel_gap,
+                            tol_infeas,
+                            settings.tol_abs,
+                            settings.tol_rel,
+                            verbosity,
+                            setup.deadline,
+                            weights,
+                            hooks);
+
+  std::unique_ptr<ConsensusADMM<T>> consensus;
+
+  if (sharded) {
+    consensus.reset(new ConsensusADMM<T>(x,
+                                         y,
+                                         weights,
+                                         settings.n_shards,
+                                         m,
+                                         family_choice,
+                                         settings.shard_worker,
+                                         settings.max_passes,
+                                         settings.tol_abs,
+                                         settings.tol_rel,
+                                         diagnostics,
+                                         setup.deadline,
+                                         hooks));
+  }
+
+  // the path is stored sparsely, one matrix for each point
+  std::vector<sp_mat> betas(n_sigma);
+  mat beta(p, m, fill::zeros);
+
+  uvec n_unique(n_sigma);
+  uvec n_variables(n_sigma);
+
+  mat linear_predictor = x*beta;
+
+  double null_deviance = 2*family->primal(y, linear_predictor);
+
+  if (resume) {
+    beta = state.beta;
+    null_deviance = state.null_deviance;
+  }
+  vec deviances(n_sigma);
+  vec deviance_ratios(n_sigma);
+
+  uvec passes(n_sigma, fill::zeros);
+  std::vector<bool> interpolated(n_sigma, false);
+  std::vector<bool> converged(n_sigma, true);
+  bool timed_out = false;
+  std::vector<std::vector<double>> primals(n_sigma);
+  std::vector<std::vector<double>> duals(n_sigma);
+  std::vector<std::vector<double>> timings(n_sigma);
+  std::vector<std::vector<unsigned>> violation_list(n_sigma);
+
+  mat gradient_prev(p, m);
+
+  // sorted magnitudes of the gradient (without the intercept), which is
+  // shared by the strong rule and KKT checks, and the coefficients it was
+  // computed at; the gradient from the final KKT check at one point is reused
+  // by the strong rule at the next
+  SortedMagnitudes sorted_gradient;
+  mat gradient_beta;
+
+  auto updateGradient = [&]() {
+    if (gradient_beta.n_rows == p && all(vectorise(gradient_beta == beta)))
+      return;
+
+    gradient_prev = family->gradient(x, y, x*beta);
+    sorted_gradient.update(gradient_prev.tail_rows(p - intercept), x.copies);
+    gradient_beta = beta;
+  };
+
+  // sets of active predictors
+  field<uvec> active_sets(n_sigma);
+  uvec active_set = regspace<uvec>(0, p-1);
+  uvec strong_set;
+  uvec ever_active_set;
+  if (intercept)
+    ever_active_set.insert_rows(0, 1);
+  if (resume)
+    ever_active_set = state.ever_active_set;
+
+  // object for use in ADMM
+  double rho = 0.0;
+  vec z(p, fill::zeros);
+  vec u(p, fill::zeros);
+  vec z_subset(z);
+  vec u_subset(u);
+  // for gaussian case
+  mat xx, L, U;
+  vec xTy;
+  decltype(matrixSubset(x, uvec())) x_subset;
+
+  // restore auxiliary variables if gaussian
+  if (admm && resume) {
+    z = state.z;
+    u = state.u;
+  }
+
+  bool factorized = false;
+
+  Results res;
+
+  // compute the strong set at sigma(k) from the gradient at the current
+  // beta, which is the solution at sigma_prev
+  auto screenPoint = [&](const uword k, const double sigma_prev) {
+    // NOTE(JL): the screening rules should probably not be used if
+    // the coefficients from the previous fit are already very dense
+
+    // step 1: compute strong set
+    updateGradient();
+
+    strong_set = activeSet(sorted_gradient,
+                           lambda*sigma(k),
+                           lambda*sigma_prev,
+                           intercept);
+  };
+
+  // step 2: start by fitting for ever active set
+  auto activatePoint = [&]() {
+    uvec prev_active = find(any(beta != 0, 1));
+
+    ever_active_set = setUnion(ever_active_set, prev_active);
+    active_set = ever_active_set;
+  };
+
+  // fit the model at sigma(k) on the columns in the active set
+  auto fitActiveSet = [&](const uword k) {
+    x_subset = matrixSubset(x, active_set);
+
+    if (active_set.n_elem == 0) {
+      // null model
+      beta.zeros();
+      passes(k) = 0;
+      return;
+    }
+
+    if (admm) {
+      if (x_subset.n_rows >= x_subset.n_cols) {
+        xx = x_subset.t()*x_subset;
+      } else {
+        xx = x_subset*x_subset.t();
+      }
+
+      vec eigval = eig_sym(xx);
+      rho = std::pow(eigval.max(), 1/3)*std::pow(lambda.max()*sigma(k), 2/3);
+
+      if (x_subset.n_rows < x_subset.n_cols)
+        xx /= rho;
+
+      xx.diag() += rho;
+
+      L = chol(xx, "lower");
+      U = L.t();
+
+      xTy = x_subset.t() * y;
+
+      z_subset = z(active_set);
+      u_subset = u(active_set);
+    }
+
+    // the penalty of the active set covers all of the copies of its columns
+    uword n_active = static_cast<uword>(accu(row_copies.elem(active_set)))
+                     - static_cast<uword>(intercept);
+    n_active *= m;
+
+    res = family->fit(x_subset,
+                      y,
+                      beta.rows(active_set),
+                      z_subset,
+                      u_subset,
+                      L,
+                      U,
+                      xTy,
+                      lambda.head(n_active)*sigma(k),
+                      rho);
+
+    if (admm) {
+      z(active_set) = z_subset;
+      u(active_set) = u_subset;
+    }
+
+    beta.rows(active_set) = res.beta;
+    passes(k) = res.passes;
+    converged[k] = res.converged;
+  };
+
+  // add the predictors outside the active set that fail the KKT check at
+  // sigma(k) to it, returning whether there were any
+  auto addFailures = [&](const KktFailures& failures,
+                         std::vector<unsigned>& violations) -> bool {
+    if (verbosity >= 2) {
+      std::ostringstream line;
+      line << "kkt-failures at:";
+
+      for (const auto j : failures.strong)
+        line << " " << j;
+
+      logLine(hooks, line.str());
+    }
+
+    uvec check_failures = failures.strong;
+
+    if (diagnostics)
+      violations.push_back(check_failures.n_elem);
+
+    if (check_failures.is_empty()) {
+      // check against whole set
+      check_failures = failures.all;
+
+      if (diagnostics)
+        violations.push_back(check_failures.n_elem);
+    }
+
+    active_set = setUnion(check_failures, active_set);
+
+    return check_failures.n_elem > 0;
+  };
+
+  // record the solver output and active set at sigma(k)
+  auto finishPoint = [&](const uword k,
+                         const std::vector<unsigned>& violations) {
+    if (diagnostics) {
+      primals[k] = res.primals;
+      duals[k] = res.duals;
+      timings[k] = res.time;
+      violation_list[k] = violations;
+    }
+
+    active_sets(k) = active_set;
+  };
+
+  // fit the model at sigma(k), warm-starting from the current beta, which
+  // is the solution at sigma_prev
+  auto fitPoint = [&](const uword k, const double sigma_prev) {
+    std::vector<unsigned> violations;
+
+    if (screening) {
+      screenPoint(k, sigma_prev);
+      activatePoint();
+    }
+
+    if (active_set.n_elem == p/m || !screening) {
+
+      // stop screening
+      screening = false;
+
+      // all features active
+      // factorize once if fitting all
+      if (!factorized && admm) {
+        // precompute x^Ty and X^tX or XX^t (if wide), unless another path
+        // already has
+        if (setup.gram.is_empty()) {
+          setup.xTy = x.t() * y;
+
+          if (n >= p) {
+            setup.gram = x.t() * x;
+          } else {
+            setup.gram = x*x.t();
+          }
+
+          setup.gram_eigenvalue = eig_sym(setup.gram).max();
+        }
+
+        xTy = setup.xTy;
+        xx = setup.gram;
+
+        // TODO(jolars): should rho be updated for each new run?
+        rho = std::pow(setup.gram_eigenvalue, 1/3)
+              *std::pow(lambda.max()*sigma(k), 2/3);
+
+        if (n < p)
+          xx /= rho;
+
+        xx.diag() += rho;
+
+        L = chol(xx, "lower");
+        U = L.t();
+
+        factorized = true;
+      }
+
+      if (sharded)
+        res = consensus->fit(beta, lambda*sigma(k));
+      else
+        res = family->fit(x, y, beta, z, u, L, U, xTy, lambda*sigma(k), rho);
+
+      passes(k) = res.passes;
+      converged[k] = res.converged;
+      beta = res.beta;
+
+    } else {
+
+      bool kkt_violation = true;
+
+      do {
+        fitActiveSet(k);
+
+        updateGradient();
+
+        kkt_violation = addFailures(kktFailures(sorted_gradient,
+                                                beta,
+                                                lambda*sigma(k),
+                                                strong_set,
+                                                active_set,
+                                                tol_infeas,
+                                                intercept),
+                                    violations);
+
+        checkCancelled(hooks);
+
+        if (kkt_violation && family->timeUp()) {
+          // out of time; keep the solution even though it is not optimal
+          converged[k] = false;
+          break;
+        }
+
+      } while (kkt_violation);
+    }
+
+    finishPoint(k, violations);
+  };
+
+  // store the current beta as the solution at sigma(k)
+  auto storePoint = [&](const uword k, const double deviance) {
+    deviances(k) = deviance;
+    deviance_ratios(k) = 1.0 - deviance/null_deviance;
+    betas[k] = sp_mat(beta);
+
+    // on the scale of the columns of the original problem
+    mat beta_copies = beta;
+    beta_copies.each_col() /= sqrt(row_copies);
+
+    n_unique(k) = unique(abs(nonzeros(beta_copies))).eval().n_elem;
+    n_variables(k) = accu(row_copies.elem(find(any(beta != 0, 1))));
+  };
+
+  // report on point k and check the criteria for stopping the path; if the
+  // path should stop, n_fitted is set to the number of points to keep
+  uword n_fitted = n_sigma;
+
+  auto stopPath = [&](const uword k) -> bool {
+    double deviance_change = 0.0;
+
+    if (k > 0) {
+      deviance_change =
+        std::abs((deviances(k-1) - deviances(k))/deviances(k-1));
+    }
+
+    uword n_coefs = n_variables(k);
+
+    if (verbosity >= 1) {
+      std::ostringstream line;
+      line.precision(4);
+      line << showpoint
+           << "penalty: "      << setw(2) << k
+           << ", dev: "        << setw(7) << deviances(k)
+           << ", dev ratio: "  << setw(7) << deviance_ratios(k)
+           << ", dev change: " << setw(7) << deviance_change
+           << ", n var: "      << setw(5) << n_coefs
+           << ", n unique: "   << setw(5) << n_unique(k)
+           << (interpolated[k] ? " (interpolated)" : "");
+      logLine(hooks, line.str());
+    }
+
+    if (n_coefs > 0 && k > 0) {
+      // stop path if fractional deviance change is small
+      if (deviance_change < tol_dev_change
+          || deviance_ratios(k) > tol_dev_ratio) {
+        n_fitted = k + 1;
+        return true;
+      }
+    }
+
+    if (n_unique(k) > max_variables) {
+      n_fitted = k;
+      return true;
+    }
+
+    return false;
+  };
+
+  // the points can also be started from given solutions (on the original
+  // scale), such as those of the full data when this is a cross-validation
+  // fold, which are usually closer than the solution at the previous point
+  const bool warm_started = !warm_start.is_empty() && !resume;
+
+  auto warmStartPoint = [&](const uword k) {
+    if (!warm_started || (k + 1)*m > warm_start.n_cols)
+      return;
+
+    beta = collapseRows(standardizeCoefficients(warm_start.cols(k*m,
+                                                               k*m + m - 1),
+                                                x_center,
+                                                x_scale,
+                                                settings.y_center,
+                                                settings.y_scale,
+                                                intercept),
+                        groups,
+                        intercept);
+
+    if (admm)
+      z = vectorise(beta);
+  };
+
+  // verify each point on another thread while the next one is fit? (not
+  // with warm starts, which replace the solution the next point starts
+  // from)
+  const bool pipelined =
+    settings.pipelined && screening && !adaptive && !warm_started;
+
+  // Fit the path with the KKT check at the tentative solution for sigma(k)
+  // running on another thread while sigma(k + 1) is fit from that solution
+  // on this one. If the check fails, the fit of sigma(k + 1) is thrown away
+  // and sigma(k) is refit with the failing predictors added, so that the
+  // path is the same as without the pipeline. Returns the point from which
+  // the path goes on without it (once all predictors are active), or n_sigma
+  // if the path is done.
+  auto fitPipelined = [&]() -> uword {
+    // the check and the fit of the next point split the threads between
+    // them, rather than each using all of them
+    const int n_threads = maxThreads();
+    const int n_check = std::max(1, n_threads/2);
+    const int n_fit = std::max(1, n_threads - n_check);
+
+    // the family is only read (see Family::gradient())
+    const Family& check_family = *family;
+
+    // this touches neither the state of the path nor the R API
+    auto checkPoint = [&](const mat beta_k,
+                          const vec lambda_k,
+                          const uvec strong_set_k,
+                          const uvec active_set_k,
+                          SortedMagnitudes sorted) {
+      onWorkerThread() = true;
+      ThreadCount thread_count(n_check);
+
+      PointCheck out;
+      out.beta = beta_k;
+      out.gradient = check_family.gradient(x, y, x*beta_k);
+      sorted.update(out.gradient.tail_rows(p - intercept), x.copies);
+      out.failures = kktFailures(sorted,
+                                 beta_k,
+                                 lambda_k,
+                                 strong_set_k,
+                                 active_set_k,
+                                 tol_infeas,
+                                 intercept);
+      out.sorted_gradient = std::move(sorted);
+
+      return out;
+    };
+
+    auto swapState = [&](PointState& other) {
+      beta.swap(other.beta);
+      active_set.swap(other.active_set);
+      ever_active_set.swap(other.ever_active_set);
+      z.swap(other.z);
+      u.swap(other.u);
+      std::swap(res, other.res);
+    };
+
+    screenPoint(0, sigma_start);
+    activatePoint();
+
+    if (active_set.n_elem == p/m)
+      return 0;
+
+    fitActiveSet(0);
+
+    uword k = 0;
+    std::vector<unsigned> violations;
+
+    while (true) {
+      auto check = std::async(std::launch::async,
+                              checkPoint,
+                              beta,
+                              vec(lambda*sigma(k)),
+                              strong_set,
+                              active_set,
+                              sorted_gradient);
+
+      // meanwhile, fit the next point, unless all predictors would be active
+      PointState previous{beta, active_set, ever_active_set, z, u, res};
+      bool speculated = false;
+
+      if (k + 1 < n_sigma) {
+        activatePoint();
+
+        if (active_set.n_elem < p/m) {
+          ThreadCount thread_count(n_fit);
+
+          fitActiveSet(k + 1);
+          speculated = true;
+        }
+      }
+
+      PointCheck point_check = check.get();
+
+      // back to sigma(k)
+      swapState(previous);
+
+      gradient_prev = std::move(point_check.gradient);
+      sorted_gradient = std::move(point_check.sorted_gradient);
+      gradient_beta = std::move(point_check.beta);
+
+      const bool kkt_violation = addFailures(point_check.failures, violations);
+
+      checkCancelled(hooks);
+
+      if (kkt_violation) {
+        if (!family->timeUp()) {
+          fitActiveSet(k);
+          continue;
+        }
+
+        // out of time; keep the solution even though it is not optimal
+        converged[k] = false;
+      }
+
+      finishPoint(k, violations);
+      violations.clear();
+      storePoint(k, res.deviance);
+
+      if (stopPath(k))
+        return n_sigma;
+
+      if (k + 1 < n_sigma && family->timeUp()) {
+        timed_out = true;
+        n_fitted = k + 1;
+        return n_sigma;
+      }
+
+      if (!speculated)
+        return k + 1;
+
+      // go on from the fit of sigma(k + 1), which is now known to have
+      // started from the solution at sigma(k)
+      swapState(previous);
+      ++k;
+
+      strong_set = activeSet(sorted_gradient,
+                             lambda*sigma(k),
+                             lambda*sigma(k - 1),
+                             intercept);
+    }
+  };
+
+  if (!adaptive) {
+
+    const uword k_start = pipelined ? fitPipelined() : 0;
+
+    for (uword k = k_start; k < n_sigma; ++k) {
+      warmStartPoint(k);
+      fitPoint(k, k == 0 ? sigma_start : sigma(k-1));
+      storePoint(k, res.deviance);
+
+      if (stopPath(k))
+        break;
+
+      if (k + 1 < n_sigma && family->timeUp()) {
+        timed_out = true;
+        n_fitted = k + 1;
+        break;
+      }
+
+      checkCancelled(hooks);
+    }
+
+  } else {
+
+    fitPoint(0, sigma_start);
+    storePoint(0, res.deviance);
+
+    // adaptive path: fit a coarse grid and only refine the segments along
+    // which the solution changes, interpolating the rest
+    uword stride = static_cast<uword>(std::ceil(std::sqrt(n_sigma)));
+
+    // restart from the solution at sigma(k)
+    auto warmStart = [&](const uword k) {
+      beta = betas[k];
+
+      if (admm)
+        z = vectorise(beta);
+    };
+
+    // does the solution differ materially between sigma(a) and sigma(b)?
+    auto pathChanges = [&](const uword a, const uword b) -> bool {
+      uvec support_a = find(any(mat(betas[a]) != 0, 1));
+      uvec support_b = find(any(mat(betas[b]) != 0, 1));
+
+      return n_unique(a) != n_unique(b)
+        || support_a.n_elem != support_b.n_elem
+        || any(support_a != support_b)
+        || std::abs(deviance_ratios(b) - deviance_ratios(a)) > tol_adaptive;
+    };
+
+    uword a = 0;
+    bool stop = stopPath(0);
+
+    while (!stop && a < n_sigma - 1) {
+      uword b = std::min(a + stride, n_sigma - 1);
+
+      warmStart(a);
+      fitPoint(b, sigma(a));
+      storePoint(b, res.deviance);
+
+      // bisect segments until the solution is flat or no points remain
+      std::vector<std::pair<uword, uword>> segments{{a, b}};
+
+      while (!segments.empty()) {
+        uword left = segments.back().first;
+        uword right = segments.back().second;
+        segments.pop_back();
+
+        if (right - left <= 1)
+          continue;
+
+        // interpolate the remaining segments if we run out of time
+        if (!family->timeUp() && pathChanges(left, right)) {
+          uword mid = (left + right)/2;
+
+          warmStart(left);
+          fitPoint(mid, sigma(left));
+          storePoint(mid, res.deviance);
+
+          segments.emplace_back(mid, right);
+          segments.emplace_back(left, mid);
+
+        } else {
+          for (uword j = left + 1; j < right; ++j) {
+            double w = (sigma(j) - sigma(right))/(sigma(left) - sigma(right));
+
+            beta = w*mat(betas[left]) + (1 - w)*mat(betas[right]);
+
+            active_sets(j) = setUnion(active_sets(left), active_sets(right));
+            interpolated[j] = true;
+            converged[j] = converged[left] && converged[right];
+
+            storePoint(j, 2*family->primal(y, x*beta));
+          }
+        }
+      }
+
+      for (uword j = a + 1; j <= b && !stop; ++j)
+        stop = stopPath(j);
+
+      if (!stop && b + 1 < n_sigma && family->timeUp()) {
+        timed_out = true;
+        stop = true;
+        n_fitted = b + 1;
+      }
+
+      a = b;
+
+      checkCancelled(hooks);
+    }
+  }
+
+  uword k = n_fitted;
+
+  betas.resize(k);
+  passes.resize(k);
+  sigma.resize(k);
+  n_unique.resize(k);
+  deviance_ratios.resize(k);
+  interpolated.resize(k);
+  converged.resize(k);
+  primals.resize(k);
+  duals.resize(k);
+  timings.resize(k);
+  violation_list.resize(k);
+  active_sets = active_sets.rows(0, std::max(static_cast<int>(k-1), 0));
+
+  // map the solutions back to the columns of the original problem
+  for (auto& beta_k : betas)
+    beta_k = expandRows(beta_k, groups, intercept, p_full);
+
+  for (uword j = 0; j < active_sets.n_elem; ++j)
+    active_sets(j) = expandIndices(active_sets(j), groups, intercept);
+
+  beta = mat(expandRows(sp_mat(beta), groups, intercept, p_full));
+  ever_active_set = expandIndices(ever_active_set, groups, intercept);
+
+  const vec z_full =
+    vectorise(mat(expandRows(sp_mat(z), groups, intercept, p_full)));
+  const vec u_full =
+    vectorise(mat(expandRows(sp_mat(u), groups, intercept, p_full)));
+
+  PathFit fit;
+
+  // solver state at the last point, from which the path can be continued
+  fit.state.x_center = x_center;
+  fit.state.x_scale = x_scale;
+  fit.state.lambda = lambda_full;
+  fit.state.sigma_max = sigma_max;
+  fit.state.sigma = k > 0 ? sigma(k-1) : sigma_start;
+  fit.state.beta = k > 0 ? mat(betas[k-1]) : beta;
+  fit.state.z = z_full;
+  fit.state.u = u_full;
+  fit.state.ever_active_set = ever_active_set;
+  fit.state.null_deviance = null_deviance;
+
+  fit.coefficients = rescale(betas,
+                             x_center,
+                             x_scale,
+                             settings.y_center,
+                             settings.y_scale,
+                             intercept);
+
+  // standardize lambda with the (weighted) number of observations
+  fit.lambda = lambda_full/accu(weights);
+
+  fit.active_sets = active_sets;
+  fit.passes = passes;
+  fit.primals = primals;
+  fit.duals = duals;
+  fit.time = timings;
+  fit.n_unique = n_unique;
+  fit.violations = violation_list;
+  fit.deviance_ratio = deviance_ratios;
+  fit.null_deviance = null_deviance;
+  fit.interpolated = interpolated;
+  fit.converged = converged;
+  fit.timed_out = timed_out;
+  fit.sigma = sigma;
+
+  return fit;
+}
+
+// Fit the paths for each of the values of settings.q (which only matters
+// for the lambda sequences that depend on q). The standardization, the
+// pruning of columns, and the Gram matrix for ADMM are shared by all of the
+// paths, and each point along a path is warm-started from the same point
+// along the path for the previous q (and the first path from warm_start,
+// which holds solutions on the original scale, if it is not empty).
+template <typename T>
+std::vector<PathFit> fitPaths(StandardizedMatrix<T>& x,
+                              const mat& y,
+                              const vec& weights,
+                              const PathSettings& settings,
+                              const sp_mat& warm_start = sp_mat())
+{
+  const bool intercept = settings.intercept;
+  const uword p = x.n_cols;
+
+  PathSetup setup;
+  setup.p_full = p;
+  setup.x_center.zeros(p);
+  setup.x_scale.ones(p);
+  setup.groups = identityGroups(p - intercept);
+
+  // time budget for the fit
+  setup.deadline = std::chrono::steady_clock::time_point::max();
+
+  if (std::isfinite(settings.max_time)) {
+    setup.deadline = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(settings.max_time));
+  }
+
+  std::vector<PathPenalty> penalties;
+
+  if (settings.resume) {
+    // the state belongs to a single path
+    const PathState& state = settings.state;
+
+    setup.x_center = state.x_center;
+    setup.x_scale = state.x_scale;
+
+    applyStandardization(x, setup.x_center, setup.x_scale, intercept);
+
+    PathPenalty penalty;
+    penalty.sigma = settings.sigma;
+    penalty.lambda = state.lambda;
+    penalty.sigma_max = state.sigma_max;
+    penalty.sigma_start = state.sigma;
+
+    penalties.push_back(penalty);
+  } else {
+    // a single pass over x for both the standardization and lambda_max
+    const ColumnStatistics stats =
+      columnStatistics(*x.data,
+                       lambdaMaxResponse(y,
+                                         weights,
+                                         settings.family,
+                                         settings.n_targets),
+                       weights,
+                       settings.center,
+                       settings.scale == "l1");
+
+    standardize(x, setup.x_center, setup.x_scale, stats, settings.scale);
+
+    for (uword i = 0; i < settings.q.n_elem; ++i) {
+      PathPenalty penalty;
+      penalty.sigma = settings.sigma;
+      penalty.lambda = settings.lambda;
+
+      regularizationPath(penalty.sigma,
+                         penalty.lambda,
+                         penalty.sigma_max,
+                         x,
+                         stats,
+                         settings.lambda_type,
+                         settings.sigma_type,
+                         settings.lambda_min_ratio,
+                         settings.q(i));
+
+      penalty.sigma_start = penalty.sigma_max;
+      penalties.push_back(penalty);
+    }
+
+    // constant columns have zero coefficients, which take up the smallest
+    // elements of lambda, so the path stays the same without them; the
+    // copies of duplicated columns are fit together
+    setup.groups = pruneColumns(x, stats, settings.rebuild_storage);
+  }
+
+  std::vector<PathFit> fits;
+  fits.reserve(penalties.size());
+
+  for (uword i = 0; i < penalties.size(); ++i) {
+    fits.push_back(fitPath(x,
+                           y,
+                           weights,
+                           settings,
+                           setup,
+                           penalties[i],
+                           i == 0 ? warm_start : fits[i - 1].coefficients));
+  }
+
+  return fits;
+}
+
+} // namespace owl
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "arma.h"
+#include <vector>
+#include "columnStatistics.h"
+#include "products.h"
+
+namespace owl {
+
+// A binary sparse matrix stored in compressed sparse column format without a
+// value array, so that every stored entry is one. The index arrays are either
+// borrowed (from the slots of an ngCMatrix in R) or owned (for subsets).
+class PatternMatrix {
+public:
+  std::vector<int> owned_ptrs;
+  std::vector<int> owned_indices;
+  const int* col_ptrs = nullptr;
+  const int* row_indices = nullptr;
+  uword n_rows = 0;
+  uword n_cols = 0;
+
+  PatternMatrix(const int* col_ptrs,
+                const int* row_indices,
+                const uword n_rows,
+                const uword n_cols)
+    : col_ptrs(col_ptrs),
+      row_indices(row_indices),
+      n_rows(n_rows),
+      n_cols(n_cols) {}
+
+  PatternMatrix(std::vector<int>&& ptrs,
+                std::vector<int>&& indices,
+                const uword n_rows,
+                const uword n_cols)
+    : owned_ptrs(std::move(ptrs)),
+      owned_indices(std::move(indices)),
+      col_ptrs(owned_ptrs.data()),
+      row_indices(owned_indices.data()),
+      n_rows(n_rows),
+      n_cols(n_cols) {}
+
+  // the pointers may point into the owned arrays, so copies are not allowed
+  PatternMatrix(const PatternMatrix&) = delete;
+  PatternMatrix(PatternMatrix&&) = default;
+
+  uword nonzeros(const uword j) const
+  {
+    return col_ptrs[j + 1] - col_ptrs[j];
+  }
+
+  // sum of the entries of r in the rows where column j is one
+  double gather(const uword j, const double* r) const
+  {
+    double out = 0.0;
+
+    for (int ind = col_ptrs[j]; ind < col_ptrs[j + 1]; ++ind)
+      out += r[row_indices[ind]];
+
+    return out;
+  }
+
+  // a copy with the ones stored explicitly
+  sp_mat toSparse() const
+  {
+    const uword n_nonzero = col_ptrs[n_cols];
+
+    uvec ptrs(n_cols + 1);
+    uvec indices(n_nonzero);
+
+    std::copy(col_ptrs, col_ptrs + n_cols + 1, ptrs.begin());
+    std::copy(row_indices, row_indices + n_nonzero, indices.begin());
+
+    return sp_mat(indices, ptrs, ones<vec>(n_nonzero), n_rows, n_cols);
+  }
+};
+
+// without a value array, the sparse kernels take every entry to be one
+inline mat matrixProduct(const PatternMatrix& x, const mat& b)
+{
+  return cscProduct<int>(x.col_ptrs,
+                         x.row_indices,
+                         nullptr,
+                         x.n_rows,
+                         x.n_cols,
+                         b);
+}
+
+inline mat matrixCrossProduct(const PatternMatrix& x, const mat& r)
+{
+  return cscCrossProduct<int>(x.col_ptrs,
+                              x.row_indices,
+                              nullptr,
+                              x.n_cols,
+                              r);
+}
+
+inline mat matrixGram(const PatternMatrix& x)
+{
+  return matrixGram(x.toSparse());
+}
+
+inline mat matrixOuterGram(const PatternMatrix& x, const rowvec& w)
+{
+  return matrixOuterGram(x.toSparse(), w);
+}
+
+inline rowvec columnSums(const PatternMatrix& x)
+{
+  rowvec sums(x.n_cols);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    sums(j) = x.nonzeros(j);
+
+  return sums;
+}
+
+// all statistics except the cross product follow from the (weighted) number
+// of ones
+inline ColumnStatistics columnStatistics(const PatternMatrix& x,
+                                         const mat& r,
+                                         const vec& w,
+                                         const bool center,
+                                         const bool l1)
+{
+  const uword p = x.n_cols;
+  const uword m = r.n_cols;
+
+  ColumnStatistics stats(p, m, accu(w));
+
+  const mat r_w = weightedResponse(r, w);
+  stats.r_sums = sum(r_w, 0);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (uword j = 0; j < p; ++j) {
+    const double w_ones = x.gather(j, w.memptr());
+    const double x_max = x.nonzeros(j) > 0 ? 1.0 : 0.0;
+
+    for (uword k = 0; k < m; ++k)
+      stats.xtr(j, k) = x.gather(j, r_w.colptr(k));
+
+    stats.setMoments(j, w_ones, w_ones, x_max, center);
+
+    if (l1) {
+      const double c = stats.center(j);
+
+      stats.l1(j) =
+        (stats.n_obs - w_ones)*std::abs(c) + w_ones*std::abs(1 - c);
+    }
+  }
+
+  return stats;
+}
+
+inline PatternMatrix matrixSubset(const PatternMatrix& x,
+                                  const uvec& active_set)
+{
+  std::vector<int> ptrs(active_set.n_elem + 1, 0);
+  std::vector<int> indices;
+
+  for (uword j = 0; j < active_set.n_elem; ++j) {
+    const uword k = active_set(j);
+
+    indices.insert(indices.end(),
+                   x.row_indices + x.col_ptrs[k],
+                   x.row_indices + x.col_ptrs[k + 1]);
+    ptrs[j + 1] = indices.size();
+  }
+
+  return PatternMatrix(std::move(ptrs),
+                       std::move(indices),
+                       x.n_rows,
+                       active_set.n_elem);
+}
+
+} // namespace owl
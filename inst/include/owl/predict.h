@@ -0,0 +1,391 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "threads.h"
+#include "utils.h"
+
+namespace owl {
+
+// the number of observations that are predicted at a time
+const uword predict_chunk_rows = 4096;
+
+// The points along a path at new values of sigma, which are linear
+// interpolations frac*left + (1 - frac)*right between two of the points that
+// were fit (or exactly one of them, if frac is one).
+struct PathInterpolation {
+  uvec left;
+  uvec right;
+  vec frac;
+};
+
+// interpolate (the decreasing) path_sigma at sigma, where values outside the
+// path are moved to its ends (as in interpolatePenalty() in R)
+inline PathInterpolation interpolatePath(const vec& path_sigma,
+                                         const vec& sigma)
+{
+  const uword n_path = path_sigma.n_elem;
+  const uword n = sigma.n_elem;
+
+  PathInterpolation out;
+  out.left.zeros(n);
+  out.right.zeros(n);
+  out.frac.ones(n);
+
+  for (uword i = 0; i < n; ++i) {
+    const double s = sigma(i);
+
+    if (n_path == 1 || s >= path_sigma(0))
+      continue;
+
+    if (s <= path_sigma(n_path - 1)) {
+      out.left(i) = out.right(i) = n_path - 1;
+      continue;
+    }
+
+    // the first point at or below s
+    uword j = 1;
+
+    while (path_sigma(j) > s)
+      ++j;
+
+    if (path_sigma(j) == s) {
+      out.left(i) = out.right(i) = j;
+    } else {
+      out.left(i) = j - 1;
+      out.right(i) = j;
+      out.frac(i) = (s - path_sigma(j))/(path_sigma(j - 1) - path_sigma(j));
+    }
+  }
+
+  return out;
+}
+
+// the points that were fit along a path of n_points points
+inline PathInterpolation pathPoints(const uword n_points)
+{
+  PathInterpolation out;
+  out.left = regspace<uvec>(0, n_points).head(n_points);
+  out.right = out.left;
+  out.frac.ones(n_points);
+
+  return out;
+}
+
+// The interpolated coefficients at the points of a path, with the m columns
+// of each point next to each other, on the (non-intercept) rows active that
+// are nonzero at one of the points that are interpolated between, and the
+// intercepts (which are zero without one)
+struct ActiveCoefficients {
+  uvec active;
+  mat beta;
+  rowvec intercepts;
+};
+
+// Interpolate the (sparse, original-scale) coefficients of a path at the
+// points given by interp. The rows that are used are found from the nonzeros
+// of the points first, so that only those rows are ever formed.
+inline ActiveCoefficients activeCoefficients(const sp_mat& coefficients,
+                                             const bool intercept,
+                                             const uword m,
+                                             const PathInterpolation& interp)
+{
+  const uword n_points = interp.frac.n_elem;
+  const uword n_rows = coefficients.n_rows;
+  const uword shift = static_cast<uword>(intercept);
+
+  std::vector<bool> used(n_rows, false);
+
+  auto markPoint = [&](const uword point) {
+    for (uword j = point*m; j < point*m + m; ++j) {
+      for (auto it = coefficients.begin_col(j);
+           it != coefficients.end_col(j);
+           ++it)
+        used[it.row()] = true;
+    }
+  };
+
+  for (uword k = 0; k < n_points; ++k) {
+    markPoint(interp.left(k));
+
+    if (interp.frac(k) < 1.0)
+      markPoint(interp.right(k));
+  }
+
+  uvec position(n_rows, fill::zeros);
+  std::vector<uword> active;
+
+  for (uword i = shift; i < n_rows; ++i) {
+    if (used[i]) {
+      position(i) = active.size();
+      active.push_back(i - shift);
+    }
+  }
+
+  ActiveCoefficients out;
+  out.active = uvec(active);
+  out.beta.zeros(active.size(), m*n_points);
+  out.intercepts.zeros(m*n_points);
+
+  auto addPoint = [&](const uword k, const uword point, const double frac) {
+    for (uword c = 0; c < m; ++c) {
+      const uword j = point*m + c;
+
+      for (auto it = coefficients.begin_col(j);
+           it != coefficients.end_col(j);
+           ++it) {
+        if (intercept && it.row() == 0)
+          out.intercepts(k*m + c) += frac*(*it);
+        else
+          out.beta(position(it.row()), k*m + c) += frac*(*it);
+      }
+    }
+  };
+
+  for (uword k = 0; k < n_points; ++k) {
+    addPoint(k, interp.left(k), interp.frac(k));
+
+    if (interp.frac(k) < 1.0)
+      addPoint(k, interp.right(k), 1.0 - interp.frac(k));
+  }
+
+  return out;
+}
+
+// the linear predictors of the observations rows (in any order) of dense x,
+// which only reads the active columns of those rows
+inline mat linearPredictors(const mat& x,
+                            const uvec& rows,
+                            const ActiveCoefficients& coefs)
+{
+  mat out(rows.n_elem, coefs.beta.n_cols, fill::zeros);
+
+  if (!coefs.active.is_empty())
+    out = x.submat(rows, coefs.active)*coefs.beta;
+
+  out.each_row() += coefs.intercepts;
+
+  return out;
+}
+
+// and of sparse x, from the nonzeros of its active columns in those rows
+inline mat linearPredictors(const sp_mat& x,
+                            const uvec& rows,
+                            const ActiveCoefficients& coefs)
+{
+  // the position of each observation in rows, if it is there
+  const uword none = rows.n_elem;
+  uvec position(x.n_rows);
+  position.fill(none);
+  position.elem(rows) = regspace<uvec>(0, rows.n_elem).head(rows.n_elem);
+
+  mat out(rows.n_elem, coefs.beta.n_cols, fill::zeros);
+
+  for (uword j = 0; j < coefs.active.n_elem; ++j) {
+    const uword col = coefs.active(j);
+
+    for (auto it = x.begin_col(col); it != x.end_col(col); ++it) {
+      const uword i = position(it.row());
+
+      if (i != none)
+        out.row(i) += (*it)*coefs.beta.row(j);
+    }
+  }
+
+  out.each_row() += coefs.intercepts;
+
+  return out;
+}
+
+// Products of chunks of (consecutive) observations with coefficients for
+// the columns cols of dense x, which are read in place
+class DenseChunks {
+public:
+  DenseChunks(const mat& x, const uvec& cols) : x(x), cols(cols) {}
+
+  mat times(const mat& beta, const uword first, const uword last) const
+  {
+    return x.submat(regspace<uvec>(first, last), cols)*beta;
+  }
+
+private:
+  const mat& x;
+  const uvec cols;
+};
+
+// whereas the columns cols of sparse x are transposed once, so that each
+// chunk is a contiguous block of columns
+class SparseChunks {
+public:
+  SparseChunks(const sp_mat& x, const uvec& cols)
+    : x_t(matrixSubset(x, cols).t()) {}
+
+  mat times(const mat& beta, const uword first, const uword last) const
+  {
+    const sp_mat chunk = x_t.cols(first, last);
+    return chunk.t()*beta;
+  }
+
+private:
+  sp_mat x_t;
+};
+
+inline DenseChunks observationChunks(const mat& x, const uvec& cols)
+{
+  return DenseChunks(x, cols);
+}
+
+inline SparseChunks observationChunks(const sp_mat& x, const uvec& cols)
+{
+  return SparseChunks(x, cols);
+}
+
+// the number of columns of the predictions of each type
+inline uword predictionColumns(const uword m,
+                               const std::string& family,
+                               const std::string& type)
+{
+  if (type == "class")
+    return 1;
+  else if (type == "response" && family == "multinomial")
+    return m + 1;
+  else
+    return m;
+}
+
+// Predictions from a path with (sparse, original-scale) coefficients with
+// the m columns of each point next to each other (and the intercept, if any,
+// in the first row) at the points given by interp, which are streamed to
+// consume(first, last, predictions) for consecutive chunks of the
+// observations first, ..., last in order. The linear predictors are formed
+// for all of the points in one product, using only the coefficients that are
+// nonzero at the points that are interpolated between (see
+// activeCoefficients()), and the link (if type is "response") or
+// the class (if type is "class"; given as the index of the class, starting
+// at 1) is applied directly. The predictions of each chunk hold its
+// observations (rows), targets or classes (columns), and points (slices).
+// Only one chunk per thread is held at a time, so that the predictions for
+// a large batch never have to be in memory at once.
+template <typename T, typename Consumer>
+void predictChunks(const T& x,
+                   const sp_mat& coefficients,
+                   const bool intercept,
+                   const uword m,
+                   const PathInterpolation& interp,
+                   const std::string& family,
+                   const std::string& type,
+                   Consumer consume)
+{
+  const uword n = x.n_rows;
+  const uword n_points = interp.frac.n_elem;
+  const bool multinomial = family == "multinomial";
+
+  // only the predictors with nonzero coefficients enter the product
+  const ActiveCoefficients coefs =
+    activeCoefficients(coefficients, intercept, m, interp);
+  const uvec& active = coefs.active;
+  const mat& beta = coefs.beta;
+  const rowvec& intercepts = coefs.intercepts;
+
+  const uword n_out = predictionColumns(m, family, type);
+
+  const auto chunks = observationChunks(x, active);
+  const uword n_chunks = (n + predict_chunk_rows - 1)/predict_chunk_rows;
+
+  // the chunks are predicted in parallel, a batch (of one chunk for each
+  // thread) at a time, and handed to consume() in order
+  const uword n_batch = std::max(maxThreads(), 1);
+  std::vector<cube> batch(n_batch);
+
+  for (uword c_first = 0; c_first < n_chunks; c_first += n_batch) {
+    const uword c_end = std::min(c_first + n_batch, n_chunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (uword c = c_first; c < c_end; ++c) {
+      const uword first = c*predict_chunk_rows;
+      const uword last = std::min(first + predict_chunk_rows, n) - 1;
+      const uword n_chunk = last - first + 1;
+
+      cube& out = batch[c - c_first];
+      out.set_size(n_chunk, n_out, n_points);
+
+      mat lin_pred(n_chunk, m*n_points, fill::zeros);
+
+      if (!active.is_empty())
+        lin_pred = chunks.times(beta, first, last);
+
+      lin_pred.each_row() += intercepts;
+
+      for (uword k = 0; k < n_points; ++k) {
+        const mat eta = lin_pred.cols(k*m, k*m + m - 1);
+
+        if (type == "link" || (type == "response" && family == "gaussian")) {
+          out.slice(k) = eta;
+
+        } else if (family == "binomial") {
+          if (type == "class")
+            out.slice(k) = conv_to<mat>::from(eta > 0) + 1.0;
+          else
+            out.slice(k) = 1.0/(1.0 + exp(-eta));
+
+        } else if (family == "poisson") {
+          out.slice(k) = exp(eta);
+
+        } else if (multinomial) {
+          // the last class is the reference class, with linear predictor
+          // zero
+          mat prob(n_chunk, m + 1, fill::zeros);
+          prob.head_cols(m) = eta;
+          prob.each_col() -= max(prob, 1);
+          prob = exp(prob);
+          prob.each_col() /= sum(prob, 1);
+
+          if (type == "class")
+            out.slice(k) = conv_to<vec>::from(index_max(prob, 1)) + 1.0;
+          else
+            out.slice(k) = prob;
+        }
+      }
+    }
+
+    for (uword c = c_first; c < c_end; ++c) {
+      const uword first = c*predict_chunk_rows;
+      const uword last = std::min(first + predict_chunk_rows, n) - 1;
+
+      consume(first, last, batch[c - c_first]);
+    }
+  }
+}
+
+// the predictions for all of the observations at once (see predictChunks()),
+// as returned to R
+template <typename T>
+cube predictPath(const T& x,
+                 const sp_mat& coefficients,
+                 const bool intercept,
+                 const uword m,
+                 const PathInterpolation& interp,
+                 const std::string& family,
+                 const std::string& type)
+{
+  cube out(x.n_rows,
+           predictionColumns(m, family, type),
+           interp.frac.n_elem);
+
+  predictChunks(x,
+                coefficients,
+                intercept,
+                m,
+                interp,
+                family,
+                type,
+                [&](const uword first, const uword last, const cube& chunk) {
+    out.rows(first, last) = chunk;
+  });
+
+  return out;
+}
+
+} // namespace owl
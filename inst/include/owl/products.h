@@ -0,0 +1,236 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include "threads.h"
+
+namespace owl {
+
+// Products with the raw (unstandardized) storage of the design matrix. Each
+// storage type provides these, and the standardization is applied on top of
+// them in StandardizedMatrix.
+
+// X*b
+inline mat matrixProduct(const mat& x, const mat& b)
+{
+  return x*b;
+}
+
+// X^T*r
+inline mat matrixCrossProduct(const mat& x, const mat& r)
+{
+  return x.t()*r;
+}
+
+// X^T*X
+inline mat matrixGram(const mat& x)
+{
+  return x.t()*x;
+}
+
+// the number of columns of dense X that are scaled at a time in
+// matrixOuterGram()
+const uword outer_gram_block_cols = 256;
+
+// X*diag(w)*X^T for non-negative w, which is summed over blocks of the
+// columns, so that x (which may be memory owned by R) is never copied whole
+inline mat matrixOuterGram(const mat& x, const rowvec& w)
+{
+  if (all(w == 1))
+    return x*x.t();
+
+  mat out(x.n_rows, x.n_rows, fill::zeros);
+
+  for (uword first = 0; first < x.n_cols; first += outer_gram_block_cols) {
+    const uword last = std::min(first + outer_gram_block_cols, x.n_cols) - 1;
+
+    mat x_block = x.cols(first, last);
+    x_block.each_row() %= sqrt(w.cols(first, last));
+
+    out += x_block*x_block.t();
+  }
+
+  return out;
+}
+
+// 1^T*X
+inline rowvec columnSums(const mat& x)
+{
+  return sum(x, 0);
+}
+
+// sparse storage
+
+// products with matrices with fewer nonzeros than this are not threaded,
+// since the overhead of the threads would dominate
+const uword parallel_min_nonzero = 10000;
+
+// out += X[, first:(last - 1)]*B[first:(last - 1), ] for compressed sparse
+// column storage (with indices of any integer type), where the values are
+// all one if values is null
+template <typename I>
+void cscAccumulate(const I* col_ptrs,
+                   const I* row_indices,
+                   const double* values,
+                   const uword first,
+                   const uword last,
+                   const mat& b,
+                   double* out,
+                   const uword n_rows)
+{
+  for (uword k = 0; k < b.n_cols; ++k) {
+    double* out_k = out + k*n_rows;
+
+    for (uword j = first; j < last; ++j) {
+      const double b_jk = b(j, k);
+
+      if (b_jk == 0.0)
+        continue;
+
+      for (I ind = col_ptrs[j]; ind < col_ptrs[j + 1]; ++ind)
+        out_k[row_indices[ind]] += (values ? values[ind] : 1.0)*b_jk;
+    }
+  }
+}
+
+// X*B, where the columns of X are split into one chunk (with roughly equal
+// numbers of nonzeros) for each thread. Each chunk is accumulated into its
+// own buffer and the buffers are summed in a fixed order, so that the result
+// does not depend on the scheduling of the threads.
+template <typename I>
+mat cscProduct(const I* col_ptrs,
+               const I* row_indices,
+               const double* values,
+               const uword n_rows,
+               const uword n_cols,
+               const mat& b)
+{
+  const uword m = b.n_cols;
+  const uword n_nonzero = col_ptrs[n_cols];
+  const uword n_chunks = n_nonzero < parallel_min_nonzero
+    ? 1
+    : std::min<uword>(maxThreads(), n_cols);
+
+  if (n_chunks <= 1) {
+    mat out(n_rows, m, fill::zeros);
+
+    cscAccumulate(col_ptrs,
+                  row_indices,
+                  values,
+                  0,
+                  n_cols,
+                  b,
+                  out.memptr(),
+                  n_rows);
+
+    return out;
+  }
+
+  uvec bounds(n_chunks + 1);
+  bounds(0) = 0;
+  bounds(n_chunks) = n_cols;
+
+  for (uword c = 1; c < n_chunks; ++c) {
+    const I target = static_cast<I>((c*n_nonzero)/n_chunks);
+    bounds(c) = std::lower_bound(col_ptrs, col_ptrs + n_cols, target)
+                - col_ptrs;
+  }
+
+  cube partial(n_rows, m, n_chunks, fill::zeros);
+
+  #pragma omp parallel for schedule(static)
+  for (uword c = 0; c < n_chunks; ++c)
+    cscAccumulate(col_ptrs,
+                  row_indices,
+                  values,
+                  bounds(c),
+                  bounds(c + 1),
+                  b,
+                  partial.slice_memptr(c),
+                  n_rows);
+
+  mat out(n_rows, m);
+
+  #pragma omp parallel for schedule(static)
+  for (uword i = 0; i < n_rows; ++i) {
+    for (uword k = 0; k < m; ++k) {
+      double sum = 0.0;
+
+      for (uword c = 0; c < n_chunks; ++c)
+        sum += partial(i, k, c);
+
+      out(i, k) = sum;
+    }
+  }
+
+  return out;
+}
+
+// X^T*R, in parallel over the columns of X (each of which is summed in a
+// fixed order)
+template <typename I>
+mat cscCrossProduct(const I* col_ptrs,
+                    const I* row_indices,
+                    const double* values,
+                    const uword n_cols,
+                    const mat& r)
+{
+  const uword m = r.n_cols;
+  const bool parallel = col_ptrs[n_cols] >= parallel_min_nonzero;
+
+  mat out(n_cols, m);
+
+  #pragma omp parallel for schedule(dynamic, 256) if (parallel)
+  for (uword j = 0; j < n_cols; ++j) {
+    for (uword k = 0; k < m; ++k) {
+      const double* r_k = r.colptr(k);
+      double xtr = 0.0;
+
+      for (I ind = col_ptrs[j]; ind < col_ptrs[j + 1]; ++ind)
+        xtr += (values ? values[ind] : 1.0)*r_k[row_indices[ind]];
+
+      out(j, k) = xtr;
+    }
+  }
+
+  return out;
+}
+
+inline mat matrixProduct(const sp_mat& x, const mat& b)
+{
+  x.sync();
+
+  return cscProduct(x.col_ptrs,
+                    x.row_indices,
+                    x.values,
+                    x.n_rows,
+                    x.n_cols,
+                    b);
+}
+
+inline mat matrixCrossProduct(const sp_mat& x, const mat& r)
+{
+  x.sync();
+
+  return cscCrossProduct(x.col_ptrs, x.row_indices, x.values, x.n_cols, r);
+}
+
+inline mat matrixGram(const sp_mat& x)
+{
+  return mat(x.t()*x);
+}
+
+inline mat matrixOuterGram(const sp_mat& x, const rowvec& w)
+{
+  sp_mat w_diag(x.n_cols, x.n_cols);
+  w_diag.diag() = w.t();
+
+  return mat(x*w_diag*x.t());
+}
+
+inline rowvec columnSums(const sp_mat& x)
+{
+  return rowvec(mat(sum(x, 0)));
+}
+
+} // namespace owl
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "threads.h"
+
+namespace owl {
+
+// prox() runs in parallel for at least this many coefficients
+const uword prox_parallel_min = 1 << 16;
+
+// decreasing magnitudes, with ties broken by position, so that the serial
+// and parallel sorts give the same order
+struct MagnitudeOrder {
+  const double* a;
+
+  bool operator()(const uword i, const uword j) const
+  {
+    return a[i] > a[j] || (a[i] == a[j] && i < j);
+  }
+};
+
+// sort chunks of the indices in parallel and then merge neighboring runs
+// pairwise, in parallel within each round
+inline std::vector<uword> sortMagnitudes(const vec& a, const int n_threads)
+{
+  const uword p = a.n_elem;
+  const MagnitudeOrder order{a.memptr()};
+
+  std::vector<uword> ind(p);
+  std::iota(ind.begin(), ind.end(), 0);
+
+  if (n_threads <= 1) {
+    std::sort(ind.begin(), ind.end(), order);
+    return ind;
+  }
+
+  const uword n_chunks = n_threads;
+  std::vector<uword> bounds(n_chunks + 1);
+
+  for (uword c = 0; c <= n_chunks; ++c)
+    bounds[c] = c*p/n_chunks;
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static)
+  for (uword c = 0; c < n_chunks; ++c)
+    std::sort(ind.begin() + bounds[c], ind.begin() + bounds[c + 1], order);
+
+  for (uword width = 1; width < n_chunks; width *= 2) {
+    #pragma omp parallel for num_threads(n_threads) schedule(static)
+    for (uword c = 0; c < n_chunks; c += 2*width) {
+      const uword mid = bounds[std::min(c + width, n_chunks)];
+      const uword end = bounds[std::min(c + 2*width, n_chunks)];
+
+      std::inplace_merge(ind.begin() + bounds[c],
+                         ind.begin() + mid,
+                         ind.begin() + end,
+                         order);
+    }
+  }
+
+  return ind;
+}
+
+// a block of pooled elements start, ..., end in the pool adjacent violators
+// algorithm, with the sum and mean of their values
+struct PoolBlock {
+  uword start;
+  uword end;
+  double sum;
+  double mean;
+};
+
+// push block onto the stack of (decreasing) blocks and pool it with the
+// blocks before it until the means decrease again, with the arithmetic of
+// the serial algorithm
+inline void poolBlock(std::vector<PoolBlock>& stack, const PoolBlock& block)
+{
+  stack.push_back(block);
+
+  while (stack.size() > 1) {
+    const PoolBlock last = stack.back();
+    PoolBlock& prev = stack[stack.size() - 2];
+
+    if (prev.mean > last.mean)
+      break;
+
+    stack.pop_back();
+
+    prev.end = last.end;
+    prev.sum += last.sum;
+    prev.mean = prev.sum/(prev.end - prev.start + 1.0);
+  }
+}
+
+// Pool d(first), ..., d(last - 1) on their own onto the empty stack blocks.
+// Returns the largest mean of the bottom block whenever it was on its own,
+// since the last block before first would have been compared with exactly
+// those means had the pooling started earlier.
+inline double poolRange(const vec& d,
+                        const uword first,
+                        const uword last,
+                        std::vector<PoolBlock>& blocks)
+{
+  double bottom_max = -datum::inf;
+
+  for (uword i = first; i < last; ++i) {
+    poolBlock(blocks, PoolBlock{i, i, d(i), d(i)});
+
+    if (blocks.size() == 1)
+      bottom_max = std::max(bottom_max, blocks[0].mean);
+  }
+
+  return bottom_max;
+}
+
+// The blocks of the non-increasing fit to d, the same as those of a single
+// pass (and with the same means). In parallel, d is split at the starts of
+// the blocks that pooling each chunk on its own and merging their stacks
+// from left to right gives, and the parts are pooled again in parallel.
+// The single pass never pools across the start of a part if the block
+// before it has a larger mean than the bottom block of the part ever had,
+// so the blocks of the part are then its own; otherwise (which takes
+// near-ties in d) the part is pooled onto the blocks before it.
+inline std::vector<PoolBlock> poolAdjacent(const vec& d, const int n_threads)
+{
+  const uword p = d.n_elem;
+  const uword n_chunks = n_threads;
+
+  std::vector<PoolBlock> blocks;
+
+  if (n_chunks <= 1 || p < 2*n_chunks) {
+    poolRange(d, 0, p, blocks);
+    return blocks;
+  }
+
+  std::vector<std::vector<PoolBlock>> stacks(n_chunks);
+
+  #pragma omp parallel for num_threads(n_threads)
+  for (uword c = 0; c < n_chunks; ++c)
+    poolRange(d, c*p/n_chunks, (c + 1)*p/n_chunks, stacks[c]);
+
+  std::vector<PoolBlock> merged = std::move(stacks[0]);
+
+  for (uword c = 1; c < n_chunks; ++c) {
+    for (const auto& block : stacks[c])
+      poolBlock(merged, block);
+  }
+
+  // the first start of a merged block at or after each chunk boundary
+  std::vector<uword> splits{0};
+  uword c_next = 1;
+
+  for (const auto& block : merged) {
+    if (c_next < n_chunks && block.start >= c_next*p/n_chunks) {
+      splits.push_back(block.start);
+
+      while (c_next < n_chunks && c_next*p/n_chunks <= block.start)
+        ++c_next;
+    }
+  }
+
+  splits.push_back(p);
+
+  const uword n_parts = splits.size() - 1;
+
+  std::vector<std::vector<PoolBlock>> parts(n_parts);
+  std::vector<double> bottom_max(n_parts);
+
+  #pragma omp parallel for num_threads(n_threads)
+  for (uword c = 0; c < n_parts; ++c)
+    bottom_max[c] = poolRange(d, splits[c], splits[c + 1], parts[c]);
+
+  blocks = std::move(parts[0]);
+
+  for (uword c = 1; c < n_parts; ++c) {
+    if (blocks.back().mean > bottom_max[c]) {
+      blocks.insert(blocks.end(), parts[c].begin(), parts[c].end());
+    } else {
+      // pool the part onto the blocks before it, as the single pass does
+      for (uword i = splits[c]; i < splits[c + 1]; ++i)
+        poolBlock(blocks, PoolBlock{i, i, d(i), d(i)});
+    }
+  }
+
+  return blocks;
+}
+
+// The proximal operator of the sorted L1 norm with weights lambda, by the
+// stack-based algorithm of Bogdan et al. (2015) on the sorted magnitudes.
+// The sort, the pooling, and the scatter back to the original order are
+// split between n_threads threads. The blocks and their means are those of
+// the serial algorithm, so the result does not depend on the number of
+// threads.
+inline mat prox(const mat& beta, const vec& lambda, int n_threads)
+{
+  const uword p = beta.n_elem;
+  n_threads = std::max(n_threads, 1);
+
+  // work with the sorted magnitudes
+  const vec beta_vec = vectorise(beta);
+  const vec beta_abs = abs(beta_vec);
+  const std::vector<uword> order = sortMagnitudes(beta_abs, n_threads);
+
+  vec d(p);
+
+  #pragma omp parallel for num_threads(n_threads) if (n_threads > 1)
+  for (uword i = 0; i < p; ++i)
+    d(i) = beta_abs(order[i]) - lambda(i);
+
+  const std::vector<PoolBlock> blocks = poolAdjacent(d, n_threads);
+
+  mat out(size(beta));
+
+  #pragma omp parallel for num_threads(n_threads) schedule(dynamic, 64) \
+    if (n_threads > 1)
+  for (uword b = 0; b < blocks.size(); ++b) {
+    const double value = std::max(blocks[b].mean, 0.0);
+
+    // reset the order and the signs
+    for (uword i = blocks[b].start; i <= blocks[b].end; ++i) {
+      const uword j = order[i];
+      out(j) = beta_vec(j) > 0 ? value : (beta_vec(j) < 0 ? -value : 0.0);
+    }
+  }
+
+  return out;
+}
+
+// long coefficient vectors use the threads of the parallel regions
+inline mat prox(const mat& beta, const vec& lambda)
+{
+  const bool parallel = beta.n_elem >= prox_parallel_min;
+
+  return prox(beta, lambda, parallel ? maxThreads() : 1);
+}
+
+// The proximal operator for rows that stand for copies(i) identical columns
+// each (see pruneColumns()): that of the sorted L1 norm over all of the
+// copies, u/sqrt(copies(i)) each. The copies of an element always end up in
+// the same block, so the stack algorithm runs on the elements with blocks
+// weighted by the number of copies they hold. This is serial, since it only
+// runs on problems with duplicated columns.
+inline mat prox(const mat& beta, const vec& lambda, const uvec& copies)
+{
+  if (copies.is_empty())
+    return prox(beta, lambda);
+
+  const uword p = beta.n_elem;
+
+  const vec beta_vec = vectorise(beta);
+  const vec k = repmat(conv_to<vec>::from(copies), beta.n_cols, 1);
+  const vec beta_abs = abs(beta_vec)/sqrt(k);
+  const std::vector<uword> order = sortMagnitudes(beta_abs, 1);
+  const vec lambda_sum = join_cols(vec{0.0}, cumsum(lambda));
+
+  struct WeightedBlock {
+    uword start;
+    uword end;
+    double sum;
+    double weight;
+  };
+
+  std::vector<WeightedBlock> blocks;
+  blocks.reserve(p);
+
+  uword position = 0;
+
+  for (uword i = 0; i < p; ++i) {
+    const uword j = order[i];
+    const uword next = position + static_cast<uword>(k(j));
+    const double d =
+      k(j)*beta_abs(j) - (lambda_sum(next) - lambda_sum(position));
+
+    position = next;
+    blocks.push_back(WeightedBlock{i, i, d, k(j)});
+
+    while (blocks.size() > 1) {
+      WeightedBlock& prev = blocks[blocks.size() - 2];
+      const WeightedBlock& last = blocks.back();
+
+      if (prev.sum/prev.weight > last.sum/last.weight)
+        break;
+
+      prev.end = last.end;
+      prev.sum += last.sum;
+      prev.weight += last.weight;
+      blocks.pop_back();
+    }
+  }
+
+  mat out(size(beta));
+
+  for (const auto& block : blocks) {
+    const double value = std::max(block.sum/block.weight, 0.0);
+
+    // reset the order and the signs, and scale back to the rows
+    for (uword i = block.start; i <= block.end; ++i) {
+      const uword j = order[i];
+      const double u = std::sqrt(k(j))*value;
+      out(j) = beta_vec(j) > 0 ? u : (beta_vec(j) < 0 ? -u : 0.0);
+    }
+  }
+
+  return out;
+}
+
+} // namespace owl
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "columnStatistics.h"
+#include "compressRows.h"
+#include "hybridMatrix.h"
+#include "standardizedMatrix.h"
+
+namespace owl {
+
+// columns whose spread around their center is smaller than this (relative
+// to the size of the center) are treated as constant, since the centering
+// leaves little more than rounding errors in them
+const double constant_column_tol = 1e-6;
+
+// the storage is only rebuilt if at least this fraction of its columns can
+// be dropped, since the columns that are kept are copied
+const double prune_storage_fraction = 0.1;
+
+// the representative (first) column of each group of identical columns
+inline uvec duplicateColumns(const mat& x)
+{
+  std::vector<std::uint64_t> h(x.n_cols, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (uword j = 0; j < x.n_cols; ++j) {
+    const double* x_j = x.colptr(j);
+
+    for (uword i = 0; i < x.n_rows; ++i)
+      h[j] = hashCombine(h[j], x_j[i]);
+  }
+
+  return groupByHash(h, [&](uword a, uword b) {
+    return columnsEqual(x, a, b);
+  });
+}
+
+inline uvec duplicateColumns(const sp_mat& x)
+{
+  x.sync();
+
+  std::vector<std::uint64_t> h(x.n_cols, 0);
+
+  for (uword j = 0; j < x.n_cols; ++j) {
+    for (uword ind = x.col_ptrs[j]; ind < x.col_ptrs[j + 1]; ++ind) {
+      h[j] = hashCombine(h[j], x.row_indices[ind]);
+      h[j] = hashCombine(h[j], x.values[ind]);
+    }
+  }
+
+  return groupByHash(h, [&](uword a, uword b) {
+    return columnsEqual(x, a, b);
+  });
+}
+
+// identical columns have the same number of nonzeros and are therefore
+// stored in the same block
+inline uvec duplicateColumns(const HybridMatrix& x)
+{
+  uvec group(x.n_cols);
+
+  group.elem(x.dense_cols) = x.dense_cols.elem(duplicateColumns(x.dense));
+  group.elem(x.sparse_cols) = x.sparse_cols.elem(duplicateColumns(x.sparse));
+
+  return group;
+}
+
+// other storage is not searched for duplicates
+template <typename T>
+uvec duplicateColumns(const T& x)
+{
+  return regspace<uvec>(0, x.n_cols - 1);
+}
+
+// does the fit hold its own copy of the storage, rather than a view of a
+// dense matrix from R (which copying would only add to)?
+inline bool ownsStorage(const mat& x)
+{
+  return x.mem_state == 0;
+}
+
+template <typename T>
+bool ownsStorage(const T&)
+{
+  return true;
+}
+
+// in-memory storage is replaced by the columns cols, which are still used
+template <typename T>
+bool pruneStorage(StandardizedMatrix<T>& x, const uvec& cols, std::true_type)
+{
+  x.data = std::make_shared<const T>(matrixSubset(*x.data, cols));
+
+  return true;
+}
+
+// whereas storage whose subsets are of another type (such as memory-mapped
+// files, whose subsets are loaded into memory) is kept as it is
+template <typename T>
+bool pruneStorage(StandardizedMatrix<T>&, const uvec&, std::false_type)
+{
+  return false;
+}
+
+// The columns of the original problem that the (non-intercept) columns of a
+// pruned problem stand for: column j stands for the identical columns
+// members(starts(j)), ..., members(starts(j + 1) - 1), the first of which is
+// keep(j)
+struct ColumnGroups {
+  uvec keep;
+  uvec members;
+  uvec starts;
+};
+
+// the groups of a problem with the p columns left as they are
+inline ColumnGroups identityGroups(const uword p)
+{
+  ColumnGroups groups;
+  groups.starts = regspace<uvec>(0, p);
+  groups.keep = groups.starts.head(p);
+  groups.members = groups.keep;
+
+  return groups;
+}
+
+// Leave the columns that are constant (after centering), and therefore have
+// zero coefficients along the whole path, out of the problem, and collapse
+// each group of k identical columns into one. SLOPE gives identical columns
+// equal coefficients b, so their group is fit as a single column scaled by
+// sqrt(k) with the coefficient sqrt(k)*b, whose copies the penalty and the
+// checks account for (see StandardizedMatrix::copies). Unless
+// rebuild_storage is false (when the storage is shared with other fits),
+// storage that the fit owns is replaced by the columns that are left if
+// that saves enough memory. Returns the groups of the original columns.
+template <typename T>
+ColumnGroups pruneColumns(StandardizedMatrix<T>& x,
+                          const ColumnStatistics& stats,
+                          const bool rebuild_storage = true)
+{
+  const uword p = x.data->n_cols;
+  const uvec keep = find(
+    stats.l2 > constant_column_tol*std::sqrt(stats.n_obs)*abs(stats.center)
+  );
+
+  if (keep.is_empty())
+    return identityGroups(p);
+
+  // the representative (first) column of the group of each column that is
+  // kept, which is kept too since it is identical
+  const uvec representative = duplicateColumns(*x.data).elem(keep);
+  const uvec reps = keep.elem(find(representative == keep));
+
+  if (reps.n_elem == p)
+    return identityGroups(p);
+
+  uvec group(p);
+  group.elem(reps) = regspace<uvec>(0, reps.n_elem - 1);
+
+  ColumnGroups groups;
+  groups.keep = reps;
+  groups.starts.zeros(reps.n_elem + 1);
+
+  for (uword i = 0; i < keep.n_elem; ++i)
+    ++groups.starts(group(representative(i)) + 1);
+
+  const uvec copies = groups.starts.tail(reps.n_elem);
+  groups.starts = cumsum(groups.starts);
+  groups.members.set_size(keep.n_elem);
+
+  uvec next = groups.starts.head(reps.n_elem);
+
+  for (uword i = 0; i < keep.n_elem; ++i)
+    groups.members(next(group(representative(i)))++) = keep(i);
+
+  x.center = x.center.cols(reps);
+  x.scale = x.scale.cols(reps);
+
+  if (any(copies > 1)) {
+    x.copies = copies;
+    x.scale /= sqrt(conv_to<rowvec>::from(copies));
+  }
+
+  if (rebuild_storage
+      && ownsStorage(*x.data)
+      && reps.n_elem <= (1 - prune_storage_fraction)*p
+      && pruneStorage(x, reps, std::is_same<SubsetType<T>, T>())) {
+    x.columns.reset();
+    x.n_cols = reps.n_elem + static_cast<uword>(x.intercept);
+  } else {
+    x.setColumns(reps);
+  }
+
+  return groups;
+}
+
+// the number of copies of each row (coefficient) of the pruned problem,
+// including the intercept
+inline vec rowCopies(const ColumnGroups& groups, const bool intercept)
+{
+  const vec copies = conv_to<vec>::from(diff(groups.starts));
+
+  if (!intercept)
+    return copies;
+
+  return join_cols(vec{1.0}, copies);
+}
+
+// The rows of a (sparse) solution of the original problem, including the
+// intercept, from the rows of the pruned problem. The coefficient of a group
+// of k copies is shared equally between them (on the scale of the copies,
+// which is sqrt(k) times smaller).
+inline sp_mat expandRows(const sp_mat& a,
+                         const ColumnGroups& groups,
+                         const bool intercept,
+                         const uword n_rows)
+{
+  const vec copies = rowCopies(groups, intercept);
+
+  uword n_nonzero = 0;
+
+  for (auto it = a.begin(); it != a.end(); ++it)
+    n_nonzero += static_cast<uword>(copies(it.row()));
+
+  umat locations(2, n_nonzero);
+  vec values(n_nonzero);
+
+  uword i = 0;
+
+  for (auto it = a.begin(); it != a.end(); ++it) {
+    const double value = *it/std::sqrt(copies(it.row()));
+
+    if (intercept && it.row() == 0) {
+      locations(0, i) = 0;
+      locations(1, i) = it.col();
+      values(i++) = value;
+      continue;
+    }
+
+    const uword j = it.row() - static_cast<uword>(intercept);
+
+    for (uword k = groups.starts(j); k < groups.starts(j + 1); ++k) {
+      locations(0, i) = groups.members(k) + static_cast<uword>(intercept);
+      locations(1, i) = it.col();
+      values(i++) = value;
+    }
+  }
+
+  return sp_mat(locations, values, n_rows, a.n_cols);
+}
+
+// the rows of the pruned problem, including the intercept, from those of the
+// original one, which is where the solutions of the pruned problem lie if
+// the copies of each group have equal coefficients
+inline mat collapseRows(const mat& a,
+                        const ColumnGroups& groups,
+                        const bool intercept)
+{
+  const uword p = groups.keep.n_elem;
+  const uword shift = static_cast<uword>(intercept);
+  const vec copies = rowCopies(groups, intercept);
+
+  mat out(p + shift, a.n_cols, fill::zeros);
+
+  if (intercept)
+    out.row(0) = a.row(0);
+
+  for (uword j = 0; j < p; ++j) {
+    for (uword k = groups.starts(j); k < groups.starts(j + 1); ++k)
+      out.row(j + shift) += a.row(groups.members(k) + shift);
+  }
+
+  out.each_col() /= sqrt(copies);
+
+  return out;
+}
+
+// the rows of the original problem, including the intercept, for the
+// (sorted) rows of the pruned problem
+inline uvec expandIndices(const uvec& rows,
+                          const ColumnGroups& groups,
+                          const bool intercept)
+{
+  const uword shift = static_cast<uword>(intercept);
+
+  std::vector<uword> out;
+  out.reserve(rows.n_elem);
+
+  for (const uword row : rows) {
+    if (intercept && row == 0) {
+      out.push_back(0);
+      continue;
+    }
+
+    const uword j = row - shift;
+
+    for (uword k = groups.starts(j); k < groups.starts(j + 1); ++k)
+      out.push_back(groups.members(k) + shift);
+  }
+
+  std::sort(out.begin(), out.end());
+
+  return uvec(out);
+}
+
+} // namespace owl
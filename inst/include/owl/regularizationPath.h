@@ -0,0 +1,111 @@
+#pragma once
+
+#include "arma.h"
+#include <cmath>
+#include "lambdaMax.h"
+
+namespace owl {
+
+// The quantile function of the standard normal distribution, from Acklam's
+// rational approximation (of the lower half, by symmetry), which is refined
+// with one step of Halley's method to (close to) machine precision.
+inline double normalQuantile(const double p)
+{
+  if (p <= 0.0)
+    return -datum::inf;
+  if (p > 0.5)
+    return -normalQuantile(1.0 - p);
+
+  static const double a[] = {-3.969683028665376e+01,  2.209460984245205e+02,
+                             -2.759285104469687e+02,  1.383577518672690e+02,
+                             -3.066479806614716e+01,  2.506628277459239e+00};
+  static const double b[] = {-5.447609879822406e+01,  1.615858368580409e+02,
+                             -1.556989798598866e+02,  6.680131188771972e+01,
+                             -1.328068155288572e+01};
+  static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                             -2.400758277161838e+00, -2.549732539343734e+00,
+                              4.374664141464968e+00,  2.938163982698783e+00};
+  static const double d[] = { 7.784695709041462e-03,  3.224671290700398e-01,
+                              2.445134137142996e+00,  3.754408661907416e+00};
+
+  const double p_low = 0.02425;
+  double x;
+
+  if (p < p_low) {
+    // the tail
+    const double t = std::sqrt(-2.0*std::log(p));
+
+    x = (((((c[0]*t + c[1])*t + c[2])*t + c[3])*t + c[4])*t + c[5])
+      /((((d[0]*t + d[1])*t + d[2])*t + d[3])*t + 1.0);
+  } else {
+    const double t = p - 0.5;
+    const double r = t*t;
+
+    x = (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*t
+      /(((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+  }
+
+  const double e = 0.5*std::erfc(-x/std::sqrt(2.0)) - p;
+  const double u = e*std::sqrt(2.0*datum::pi)*std::exp(0.5*x*x);
+
+  return x - u/(1.0 + 0.5*x*u);
+}
+
+template <typename T>
+void regularizationPath(vec& sigma,
+                        vec& lambda,
+                        double& sigma_max,
+                        const T& x,
+                        const ColumnStatistics& stats,
+                        const std::string lambda_type,
+                        const std::string sigma_type,
+                        const double lambda_min_ratio,
+                        const double q)
+{
+  // the (weighted) number of observations
+  const double n = stats.n_obs;
+  const sword n_lambda = lambda.n_elem;
+  const uword n_sigma = sigma.n_elem;
+
+  if (lambda_type == "gaussian" || lambda_type == "bh") {
+    lambda = regspace(1, n_lambda)*q/(2*n_lambda);
+
+    lambda.transform([](double val) {
+      return -normalQuantile(val);
+    });
+
+    if (lambda_type == "gaussian" && n_lambda > 1) {
+      double sum_sq = 0.0;
+
+      for (sword i = 1; i < n_lambda; ++i) {
+        sum_sq += std::pow(lambda(i - 1), 2);
+        double w = std::max(1.0, n - i - 1);
+        lambda(i) *= std::sqrt(1.0 + sum_sq/w);
+      }
+
+      // ensure non-increasing lambda
+      lambda.tail(n_lambda - lambda.index_min()).fill(min(lambda));
+    }
+
+  } else if (lambda_type == "oscar") {
+
+    lambda = q*(regspace(n_lambda, 1) - 1) + 1;
+
+  } else if (lambda_type == "user") {
+    // standardize lambda with number of observations
+    lambda *= n;
+  }
+
+  vec lambda_max = lambdaMax(x, stats);
+
+  sigma_max =
+    (cumsum(sort(abs(lambda_max), "descending"))/cumsum(lambda)).max();
+
+  if (sigma_type == "auto") {
+    sigma = exp(linspace(log(sigma_max),
+                         log(sigma_max*lambda_min_ratio),
+                         n_sigma));
+  }
+}
+
+} // namespace owl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "arma.h"
+
+namespace owl {
+
+// rescale the coefficients along the path to the original scale of the data
+// and collect them in a sparse matrix with the m columns of each point along
+// the path stored next to each other
+inline sp_mat rescale(const std::vector<sp_mat>& betas,
+                      const rowvec& x_center,
+                      const rowvec& x_scale,
+                      const rowvec& y_center,
+                      const rowvec& y_scale,
+                      const bool intercept)
+{
+  const uword p = x_scale.n_elem;
+  const uword m = y_scale.n_elem;
+  const uword n_sigma = betas.size();
+
+  uword max_nonzero = 0;
+
+  for (const auto& beta : betas)
+    max_nonzero += beta.n_nonzero + m;
+
+  umat locations(2, max_nonzero);
+  vec values(max_nonzero);
+
+  uword i = 0;
+
+  for (uword s = 0; s < n_sigma; ++s) {
+    rowvec x_bar_beta_sum(m, fill::zeros);
+    rowvec intercepts(m, fill::zeros);
+
+    for (auto it = betas[s].begin(); it != betas[s].end(); ++it) {
+      const uword j = it.row();
+      const uword k = it.col();
+
+      if (intercept && j == 0) {
+        intercepts(k) = *it;
+        continue;
+      }
+
+      double value = (*it)*y_scale(k)/x_scale(j);
+      x_bar_beta_sum(k) += x_center(j)*value;
+
+      locations(0, i) = j;
+      locations(1, i) = s*m + k;
+      values(i) = value;
+      ++i;
+    }
+
+    if (intercept) {
+      for (uword k = 0; k < m; ++k) {
+        locations(0, i) = 0;
+        locations(1, i) = s*m + k;
+        values(i) =
+          intercepts(k)*y_scale(k) + y_center(k) - x_bar_beta_sum(k);
+        ++i;
+      }
+    }
+  }
+
+  locations.resize(2, i);
+  values.resize(i);
+
+  return sp_mat(locations, values, p, m*n_sigma, true, true);
+}
+
+// the inverse of rescale() for the coefficients at a single point along the
+// path: put them on the standardized scale of the data
+inline mat standardizeCoefficients(const sp_mat& coefficients,
+                                   const rowvec& x_center,
+                                   const rowvec& x_scale,
+                                   const rowvec& y_center,
+                                   const rowvec& y_scale,
+                                   const bool intercept)
+{
+  const uword m = coefficients.n_cols;
+
+  mat beta(coefficients);
+  rowvec x_bar_beta_sum(m, fill::zeros);
+
+  for (uword j = intercept; j < beta.n_rows; ++j) {
+    x_bar_beta_sum += x_center(j)*beta.row(j);
+    beta.row(j) *= x_scale(j);
+  }
+
+  if (intercept)
+    beta.row(0) += x_bar_beta_sum - y_center;
+
+  beta.each_row() /= y_scale;
+
+  return beta;
+}
+
+} // namespace owl
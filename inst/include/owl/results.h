@@ -1,9 +1,8 @@
 #pragma once
 
-#include <RcppArmadillo.h>
+#include "arma.h"
 
-using namespace Rcpp;
-using namespace arma;
+namespace owl {
 
 struct Results {
   mat beta;
@@ -12,6 +11,7 @@ struct Results {
   std::vector<double> duals;
   std::vector<double> time;
   double deviance;
+  bool converged;
 
   Results() {}
 
@@ -20,11 +20,15 @@ struct Results {
           std::vector<double> primals,
           std::vector<double> duals,
           std::vector<double> time,
-          double deviance)
+          double deviance,
+          bool converged)
     : beta(beta),
       passes(passes),
       primals(primals),
       duals(duals),
       time(time),
-      deviance(deviance) {}
+      deviance(deviance),
+      converged(converged) {}
 };
+
+} // namespace owl
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "arma.h"
+#include "sortedMagnitudes.h"
+
+namespace owl {
+
+// gradient_prev holds the sorted magnitudes of the gradient at the previous
+// solution, not including the intercept, of which each element stands for
+// all of its copies
+inline uvec activeSet(const SortedMagnitudes& gradient_prev,
+                      const vec& lambda,
+                      const vec& lambda_prev,
+                      const bool intercept)
+{
+  const uword m = gradient_prev.n_cols;
+  const uword p = lambda.n_elem;
+  const vec tmp = gradient_prev.expanded() + lambda_prev - 2*lambda;
+
+  uword i = 0;
+  uword k = 0;
+
+  double s = 0;
+
+  while (i + k < p) {
+    s += tmp(k+i);
+
+    if (s >= 0) {
+      k = k + i + 1;
+      i = 0;
+      s = 0;
+    } else {
+      i++;
+    }
+  }
+
+  // the elements whose first copy is among the first k
+  const uword n_elem = gradient_prev.values.n_elem;
+  uvec active_set(n_elem, fill::zeros);
+
+  if (gradient_prev.counts.is_empty()) {
+    active_set.head(k).ones();
+  } else {
+    uword first = 0;
+
+    for (uword j = 0; j < n_elem && first < k; ++j) {
+      active_set(j) = 1;
+      first += static_cast<uword>(gradient_prev.counts(j));
+    }
+  }
+
+  // reset order
+  active_set(gradient_prev.order) = active_set;
+
+  umat active_set_mat = reshape(active_set, n_elem/m, m);
+
+  uvec out = find(any(active_set_mat, 1));
+
+  if (intercept) {
+    // shuffle all orders by one and add an index for the intercept
+    out += 1;
+    urowvec top = {0};
+    out.insert_rows(0, top);
+  }
+
+  return out;
+}
+
+} // namespace owl
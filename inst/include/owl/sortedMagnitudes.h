@@ -0,0 +1,154 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+
+namespace owl {
+
+// Absolute values of a matrix sorted in decreasing order along with their
+// ordering and cumulative sums, shared between the infeasibility, KKT, and
+// strong rule checks. Successive updates tend to come from nearly sorted
+// sequences (gradients or coefficients along the solver and regularization
+// paths), so the previous ordering is repaired with an insertion sort if
+// possible, falling back to a full sort if the order has changed too much.
+//
+// If the rows stand for several copies of identical columns (see
+// pruneColumns()), each element of row i stands for copies(i) elements
+// u/sqrt(copies(i)) of the vector of the original problem, whose magnitudes
+// these are; counts then holds the copies of each (sorted) element and
+// cumulative the sums over all of the copies.
+struct SortedMagnitudes {
+  uvec order;
+  vec values;
+  vec counts;
+  vec cumulative;
+  uword n_rows = 0;
+  uword n_cols = 0;
+
+  void update(const mat& x, const uvec& copies = uvec())
+  {
+    vec abs_x = abs(vectorise(x));
+
+    n_rows = x.n_rows;
+    n_cols = x.n_cols;
+
+    vec element_copies;
+
+    if (!copies.is_empty()) {
+      element_copies = repmat(conv_to<vec>::from(copies), n_cols, 1);
+      abs_x /= sqrt(element_copies);
+    }
+
+    if (order.n_elem != abs_x.n_elem || !repairOrder(abs_x))
+      order = sort_index(abs_x, "descend");
+
+    values = abs_x(order);
+
+    if (copies.is_empty()) {
+      counts.reset();
+      cumulative = cumsum(values);
+    } else {
+      counts = element_copies(order);
+      cumulative = cumsum(values % counts);
+    }
+  }
+
+  // The largest difference between the partial sums of the magnitudes and
+  // those of lambda over the positions of each element. Within the copies of
+  // an element, the difference is convex in the position (lambda is
+  // decreasing), so it is largest at the first or the last copy.
+  vec excess(const vec& lambda) const
+  {
+    const vec lambda_sum = cumsum(lambda);
+
+    if (counts.is_empty())
+      return cumulative - lambda_sum;
+
+    vec out(values.n_elem);
+    uword end = 0;
+
+    for (uword i = 0; i < values.n_elem; ++i) {
+      const uword k = static_cast<uword>(counts(i));
+      const uword first = end;
+      end += k;
+
+      const double at_first =
+        cumulative(i) - (k - 1)*values(i) - lambda_sum(first);
+
+      out(i) = std::max(at_first, cumulative(i) - lambda_sum(end - 1));
+    }
+
+    return out;
+  }
+
+  // the sorted L1 norm with weights lambda
+  double penalty(const vec& lambda) const
+  {
+    if (counts.is_empty())
+      return dot(values, lambda);
+
+    const vec lambda_sum = join_cols(vec{0.0}, cumsum(lambda));
+    const vec ends = cumsum(counts);
+
+    double out = 0.0;
+
+    for (uword i = 0; i < values.n_elem; ++i) {
+      const uword end = static_cast<uword>(ends(i));
+      const uword start = end - static_cast<uword>(counts(i));
+
+      out += values(i)*(lambda_sum(end) - lambda_sum(start));
+    }
+
+    return out;
+  }
+
+  // the magnitudes with each element repeated for its copies
+  vec expanded() const
+  {
+    if (counts.is_empty())
+      return values;
+
+    vec out(static_cast<uword>(accu(counts)));
+    uword end = 0;
+
+    for (uword i = 0; i < values.n_elem; ++i) {
+      const uword k = static_cast<uword>(counts(i));
+      out.subvec(end, end + k - 1).fill(values(i));
+      end += k;
+    }
+
+    return out;
+  }
+
+private:
+  // insertion sort of the previous ordering, which gives up (leaving order
+  // invalid) if more than a few moves per element are needed
+  bool repairOrder(const vec& abs_x)
+  {
+    const uword n = order.n_elem;
+    const uword max_moves = 8*n;
+
+    uword moves = 0;
+
+    for (uword i = 1; i < n; ++i) {
+      const uword ind = order(i);
+      const double val = abs_x(ind);
+
+      uword j = i;
+
+      while (j > 0 && abs_x(order(j - 1)) < val) {
+        order(j) = order(j - 1);
+        --j;
+
+        if (++moves > max_moves)
+          return false;
+      }
+
+      order(j) = ind;
+    }
+
+    return true;
+  }
+};
+
+} // namespace owl
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "arma.h"
+#include "columnStatistics.h"
+#include "standardizedMatrix.h"
+
+namespace owl {
+
+// set up the (implicit) standardization of x from its column statistics and
+// return it (including the intercept) in x_center and x_scale
+template <typename T>
+void standardize(StandardizedMatrix<T>& x,
+                 rowvec& x_center,
+                 rowvec& x_scale,
+                 const ColumnStatistics& stats,
+                 const std::string& scale)
+{
+  const uword p = x.data->n_cols;
+
+  x.center = stats.center;
+
+  if (scale == "l1") {
+    x.scale = stats.l1;
+  } else if (scale == "l2") {
+    x.scale = stats.l2;
+  } else if (scale == "sd") {
+    x.scale = stats.sd;
+  } else if (scale == "max") {
+    x.scale = stats.max;
+  } else {
+    x.scale.ones();
+  }
+
+  // don't scale zero-variance predictors
+  x.scale.replace(0.0, 1.0);
+
+  x_center.tail(p) = x.center;
+  x_scale.tail(p) = x.scale;
+}
+
+// apply a previously computed standardization to x
+template <typename T>
+void applyStandardization(StandardizedMatrix<T>& x,
+                          const rowvec& x_center,
+                          const rowvec& x_scale,
+                          bool intercept)
+{
+  const uword p = x.data->n_cols;
+
+  x.center = x_center.tail(p);
+  x.scale = x_scale.tail(p);
+}
+
+} // namespace owl
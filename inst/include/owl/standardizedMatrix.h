@@ -0,0 +1,260 @@
+#pragma once
+
+#include "arma.h"
+#include <memory>
+#include <utility>
+#include "products.h"
+#include "utils.h"
+
+namespace owl {
+
+template <typename T>
+class StandardizedMatrix;
+
+// lazy transpose of a StandardizedMatrix, used to write products as x.t()*r
+template <typename T>
+struct StandardizedMatrixTrans {
+  const StandardizedMatrix<T>& x;
+};
+
+// A design matrix that is centered and scaled implicitly. The data is never
+// modified (and, for input from R, not even copied); instead, the centering
+// and scaling are applied as corrections inside the products with it. If
+// intercept is true, the matrix also has an implicit leading column of ones.
+//
+// The (non-intercept) columns are the columns of data, unless columns is
+// set, in which case column j is column columns(j) of data. This way,
+// columns of data can be left out of the problem without copying it.
+//
+// If copies is set, (non-intercept) column j stands for copies(j) identical
+// columns of the original problem, which have been collapsed into it (see
+// pruneColumns()), and the penalty counts its coefficient that many times.
+template <typename T>
+class StandardizedMatrix {
+public:
+  std::shared_ptr<const T> data;
+  uvec columns;
+  uvec copies;
+  rowvec center;
+  rowvec scale;
+  bool intercept = false;
+  uword n_rows = 0;
+  uword n_cols = 0;
+
+  StandardizedMatrix() {}
+
+  StandardizedMatrix(std::shared_ptr<const T> data, const bool intercept)
+    : data(data),
+      center(data->n_cols, fill::zeros),
+      scale(data->n_cols, fill::ones),
+      intercept(intercept),
+      n_rows(data->n_rows),
+      n_cols(data->n_cols + static_cast<uword>(intercept)) {}
+
+  StandardizedMatrixTrans<T> t() const
+  {
+    return {*this};
+  }
+
+  // use the given columns of data as the (non-intercept) columns
+  void setColumns(const uvec& cols)
+  {
+    columns = cols;
+    n_cols = cols.n_elem + static_cast<uword>(intercept);
+  }
+
+  // sum the rows of a (one for each column) that share a column of data
+  mat toData(const mat& a) const
+  {
+    if (columns.is_empty())
+      return a;
+
+    mat out(data->n_cols, a.n_cols, fill::zeros);
+
+    for (uword j = 0; j < columns.n_elem; ++j)
+      out.row(columns(j)) += a.row(j);
+
+    return out;
+  }
+
+  // pick out the rows of a (one for each column of data) for the columns
+  mat fromData(const mat& a) const
+  {
+    if (columns.is_empty())
+      return a;
+
+    return a.rows(columns);
+  }
+
+  // X*b
+  mat multiply(const mat& b) const
+  {
+    const uword p = n_cols - static_cast<uword>(intercept);
+
+    mat b_scaled = b.tail_rows(p);
+    b_scaled.each_col() /= scale.t();
+
+    mat out = matrixProduct(*data, toData(b_scaled));
+    out.each_row() -= center*b_scaled;
+
+    if (intercept)
+      out.each_row() += b.row(0);
+
+    return out;
+  }
+
+  // X^T*r
+  mat crossProduct(const mat& r) const
+  {
+    const uword p = n_cols - static_cast<uword>(intercept);
+
+    const rowvec r_sums = sum(r, 0);
+
+    mat xtr = fromData(matrixCrossProduct(*data, r));
+    xtr -= center.t()*r_sums;
+    xtr.each_col() /= scale.t();
+
+    if (!intercept)
+      return xtr;
+
+    mat out(p + 1, r.n_cols);
+    out.row(0) = r_sums;
+    out.tail_rows(p) = xtr;
+
+    return out;
+  }
+
+  // X^T*X
+  mat gram() const
+  {
+    const uword p = n_cols - static_cast<uword>(intercept);
+    const double n = n_rows;
+
+    const rowvec x_sums = fromData(columnSums(*data).t()).t();
+
+    mat g = matrixGram(*data);
+
+    if (!columns.is_empty())
+      g = mat(g.submat(columns, columns));
+
+    g -= center.t()*x_sums + x_sums.t()*center - n*center.t()*center;
+    g.each_col() /= scale.t();
+    g.each_row() /= scale;
+
+    if (!intercept)
+      return g;
+
+    const rowvec x_bar = (x_sums - n*center)/scale;
+
+    mat out(p + 1, p + 1);
+    out(0, 0) = n;
+    out.submat(0, 1, 0, p) = x_bar;
+    out.submat(1, 0, p, 0) = x_bar.t();
+    out.submat(1, 1, p, p) = g;
+
+    return out;
+  }
+
+  // X*X^T
+  mat outerGram() const
+  {
+    const rowvec w = 1/square(scale);
+    const rowvec center_w = center % w;
+
+    mat g = matrixOuterGram(*data, toData(w.t()).t());
+
+    const vec v = matrixProduct(*data, toData(center_w.t()));
+
+    g.each_col() -= v;
+    g.each_row() -= v.t();
+    g += dot(center_w, center) + static_cast<double>(intercept);
+
+    return g;
+  }
+};
+
+template <typename T>
+inline mat operator*(const StandardizedMatrix<T>& x, const mat& b)
+{
+  return x.multiply(b);
+}
+
+template <typename T>
+inline mat operator*(const StandardizedMatrixTrans<T>& xt, const mat& r)
+{
+  return xt.x.crossProduct(r);
+}
+
+template <typename T>
+inline mat operator*(const StandardizedMatrixTrans<T>& xt,
+                     const StandardizedMatrix<T>& x)
+{
+  return x.gram();
+}
+
+template <typename T>
+inline mat operator*(const StandardizedMatrix<T>& x,
+                     const StandardizedMatrixTrans<T>& xt)
+{
+  return x.outerGram();
+}
+
+// the type of an (in-memory) subset of the columns of storage type T
+template <typename T>
+using SubsetType = decltype(matrixSubset(std::declval<const T&>(),
+                                         std::declval<const uvec&>()));
+
+// subset columns (indexed including the intercept) of a standardized matrix
+template <typename T>
+StandardizedMatrix<SubsetType<T>>
+matrixSubset(const StandardizedMatrix<T>& x, const uvec& active_set)
+{
+  const bool intercept = x.intercept
+                         && active_set.n_elem > 0
+                         && active_set(0) == 0;
+
+  uvec cols = active_set.tail(active_set.n_elem - intercept);
+
+  if (x.intercept)
+    cols -= 1;
+
+  if (x.columns.is_empty()) {
+    StandardizedMatrix<SubsetType<T>> x_subset(
+      std::make_shared<const SubsetType<T>>(matrixSubset(*x.data, cols)),
+      intercept
+    );
+
+    x_subset.center = x.center.cols(cols);
+    x_subset.scale = x.scale.cols(cols);
+
+    if (!x.copies.is_empty())
+      x_subset.copies = x.copies.elem(cols);
+
+    return x_subset;
+  }
+
+  // columns that share storage in x also share it in the subset
+  const uvec data_cols = x.columns.elem(cols);
+  const uvec unique_cols = unique(data_cols);
+
+  uvec position(x.data->n_cols);
+
+  for (uword j = 0; j < unique_cols.n_elem; ++j)
+    position(unique_cols(j)) = j;
+
+  StandardizedMatrix<SubsetType<T>> x_subset(
+    std::make_shared<const SubsetType<T>>(matrixSubset(*x.data, unique_cols)),
+    intercept
+  );
+
+  x_subset.setColumns(position.elem(data_cols));
+  x_subset.center = x.center.cols(cols);
+  x_subset.scale = x.scale.cols(cols);
+
+  if (!x.copies.is_empty())
+    x_subset.copies = x.copies.elem(cols);
+
+  return x_subset;
+}
+
+} // namespace owl
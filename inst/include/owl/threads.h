@@ -0,0 +1,116 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace owl {
+
+// the number of threads that parallel regions use
+inline int maxThreads()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+// Sets the number of threads for the parallel regions (if n_threads is
+// positive; otherwise the OpenMP default is kept) for the lifetime of the
+// object, after which the previous number is restored.
+class ThreadCount {
+public:
+  explicit ThreadCount(const int n_threads)
+  {
+#ifdef _OPENMP
+    previous = omp_get_max_threads();
+
+    if (n_threads > 0)
+      omp_set_num_threads(n_threads);
+#endif
+  }
+
+  ~ThreadCount()
+  {
+#ifdef _OPENMP
+    omp_set_num_threads(previous);
+#endif
+  }
+
+  ThreadCount(const ThreadCount&) = delete;
+  ThreadCount& operator=(const ThreadCount&) = delete;
+
+private:
+  int previous = 1;
+};
+
+// Is the calling thread one of the worker threads started by parallelTasks()?
+// The R API must not be used on those.
+inline bool& onWorkerThread()
+{
+  static thread_local bool worker = false;
+  return worker;
+}
+
+// Run task(t, n_inner) for t = 0, ..., n_tasks - 1 on n_threads threads
+// (including the calling one), where n_inner is the number of threads left
+// for the parallel regions within each task. The threads take the next task
+// from a shared counter as soon as they are done with the previous one, so
+// that tasks of uneven size are balanced. After the first exception, no new
+// tasks are started, and the exception is rethrown once all threads are done.
+template <typename Task>
+void parallelTasks(const arma::uword n_tasks, const int n_threads, Task task)
+{
+  const int n_workers =
+    std::max(1, std::min(n_threads, static_cast<int>(n_tasks)));
+  const int n_inner = std::max(1, n_threads/n_workers);
+
+  std::atomic<arma::uword> next(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto work = [&](const bool worker) {
+    onWorkerThread() = worker;
+    ThreadCount thread_count(n_inner);
+
+    arma::uword t;
+
+    while (!failed && (t = next++) < n_tasks) {
+      try {
+        task(t, n_inner);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+
+        if (!failed) {
+          error = std::current_exception();
+          failed = true;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (int i = 1; i < n_workers; ++i)
+    threads.emplace_back(work, true);
+
+  work(false);
+
+  for (auto& thread : threads)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace owl
@@ -1,15 +1,18 @@
 #pragma once
 
-#include <RcppArmadillo.h>
+#include "arma.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
-using namespace arma;
+namespace owl {
 
-mat matrixSubset(const mat& x, const uvec& active_set)
+inline mat matrixSubset(const mat& x, const uvec& active_set)
 {
   return x.cols(active_set);
 }
 
-sp_mat matrixSubset(const sp_mat& x, const uvec& active_set)
+inline sp_mat matrixSubset(const sp_mat& x, const uvec& active_set)
 {
   const uword p = active_set.n_elem;
   const uword n = x.n_rows;
@@ -34,8 +37,7 @@ inline uvec setUnion(const uvec& a, const uvec& b)
   return conv_to<uvec>::from(out);
 }
 
-
-inline uvec setDiff(uvec& a, uvec& b)
+inline uvec setDiff(const uvec& a, const uvec& b)
 {
   std::vector<unsigned> out;
   std::set_difference(a.begin(), a.end(),
@@ -45,13 +47,4 @@ inline uvec setDiff(uvec& a, uvec& b)
   return conv_to<uvec>::from(out);
 }
 
-inline bool isSparse(SEXP x)
-{
-  bool is_sparse = false;
-
-  if (Rf_isS4(x))
-    if (Rf_inherits(x, "dgCMatrix"))
-      is_sparse = true;
-
-  return is_sparse;
-}
+} // namespace owl
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "arma.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace owl {
+
+// Elementwise exp, log, and log(1 + exp) for the families, written without
+// branches or calls to libm so that the loops over them are vectorized. The
+// kernels are compiled for AVX-512 and AVX2 as well as for the baseline
+// instruction set, and the widest one that the processor supports is picked
+// at run time. Against libm, the relative errors are at most 2 ulp for exp,
+// 4 ulp for log, and 5 ulp for log(1 + exp) (and for the log-sum-exp, which
+// is built from them), except that exp(x) and log(1 + exp(x)) are zero for
+// x < -707.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+  && !defined(OWL_NO_SIMD_DISPATCH)
+#define OWL_SIMD_DISPATCH
+#endif
+
+namespace vector_math {
+
+const double ln2_hi = 6.93147180369123816490e-01;
+const double ln2_lo = 1.90821492927058770002e-10;
+const double log2_e = 1.4426950408889634;
+const double sqrt_2 = 1.4142135623730951;
+
+// adding this rounds to an integer that is kept in the low bits
+const double round_shift = 6755399441055744.0;
+
+// exp() is truncated at the largest double (like trunc_exp()) above
+// exp_max_arg and flushed to zero below exp_min_arg (where it is smaller
+// than 1e-307)
+const double exp_max_arg = 709.782712893384;
+const double exp_min_arg = -707.0;
+
+inline std::uint64_t toBits(const double x)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+inline double fromBits(const std::uint64_t bits)
+{
+  double x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+// exp(x) = 2^k*exp(r) with |r| <= log(2)/2, where exp(r) is given by its
+// Taylor polynomial of degree 13
+inline double expElement(const double x)
+{
+  const double max_double = std::numeric_limits<double>::max();
+
+  const double x_c = std::min(std::max(x, exp_min_arg), exp_max_arg);
+  const double k_shifted = x_c*log2_e + round_shift;
+  const double k = k_shifted - round_shift;
+  const double r = (x_c - k*ln2_hi) - k*ln2_lo;
+
+  double p = 1.0/6227020800.0;
+  p = p*r + 1.0/479001600.0;
+  p = p*r + 1.0/39916800.0;
+  p = p*r + 1.0/3628800.0;
+  p = p*r + 1.0/362880.0;
+  p = p*r + 1.0/40320.0;
+  p = p*r + 1.0/5040.0;
+  p = p*r + 1.0/720.0;
+  p = p*r + 1.0/120.0;
+  p = p*r + 1.0/24.0;
+  p = p*r + 1.0/6.0;
+  p = p*r + 0.5;
+  p = p*r + 1.0;
+  p = p*r + 1.0;
+
+  // 2^(k - 1), which is a normal number for all k in range, times two
+  const std::uint64_t k_bits = toBits(k_shifted) - toBits(round_shift);
+  const double scale = fromBits((k_bits + 1022) << 52);
+  const double y = std::min(2.0*(p*scale), max_double);
+
+  return x >= exp_max_arg ? max_double : (x < exp_min_arg ? 0.0 : y);
+}
+
+// log(x) for positive, normal x, from x = 2^e*a with a in [sqrt(1/2),
+// sqrt(2)) and the series of log(a) = 2*atanh((a - 1)/(a + 1))
+inline double logElement(const double x)
+{
+  const std::uint64_t bits = toBits(x);
+
+  // the biased exponent, converted to a double by placing it in the
+  // mantissa of 2^52
+  const double e_biased =
+    fromBits((bits >> 52) | 0x4330000000000000ULL) - 4503599627370496.0;
+
+  double a = fromBits((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+
+  const bool big = a > sqrt_2;
+  a = big ? 0.5*a : a;
+
+  const double e = e_biased - 1023.0 + (big ? 1.0 : 0.0);
+
+  const double s = (a - 1.0)/(a + 1.0);
+  const double s2 = s*s;
+
+  double q = 1.0/25.0;
+  q = q*s2 + 1.0/23.0;
+  q = q*s2 + 1.0/21.0;
+  q = q*s2 + 1.0/19.0;
+  q = q*s2 + 1.0/17.0;
+  q = q*s2 + 1.0/15.0;
+  q = q*s2 + 1.0/13.0;
+  q = q*s2 + 1.0/11.0;
+  q = q*s2 + 1.0/9.0;
+  q = q*s2 + 1.0/7.0;
+  q = q*s2 + 1.0/5.0;
+  q = q*s2 + 1.0/3.0;
+  q = q*s2 + 1.0;
+
+  return e*ln2_hi + (e*ln2_lo + 2.0*s*q);
+}
+
+// log(1 + exp(x)) = max(x, 0) + log1p(exp(-|x|)), where log1p(u) is
+// computed as log(1 + u)*u/((1 + u) - 1) to cancel the rounding of 1 + u
+inline double log1pExpElement(const double x)
+{
+  const double u = expElement(-std::abs(x));
+  const double a = 1.0 + u;
+  const double log1p_u = a == 1.0 ? u : logElement(a)*u/(a - 1.0);
+
+  return std::max(x, 0.0) + log1p_u;
+}
+
+template <double (*f)(double)>
+inline void mapElements(const double* x, double* out, const uword n)
+{
+  #pragma omp simd
+  for (uword i = 0; i < n; ++i)
+    out[i] = f(x[i]);
+}
+
+#ifdef OWL_SIMD_DISPATCH
+
+template <double (*f)(double)>
+__attribute__((target("avx2,fma")))
+void mapElementsAvx2(const double* x, double* out, const uword n)
+{
+  #pragma omp simd
+  for (uword i = 0; i < n; ++i)
+    out[i] = f(x[i]);
+}
+
+template <double (*f)(double)>
+__attribute__((target("avx512f")))
+void mapElementsAvx512(const double* x, double* out, const uword n)
+{
+  #pragma omp simd
+  for (uword i = 0; i < n; ++i)
+    out[i] = f(x[i]);
+}
+
+enum class SimdLevel { baseline, avx2, avx512 };
+
+inline SimdLevel simdLevel()
+{
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+      return SimdLevel::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return SimdLevel::avx2;
+
+    return SimdLevel::baseline;
+  }();
+
+  return level;
+}
+
+#endif
+
+// out = f(x) elementwise, with the widest kernel available
+template <double (*f)(double)>
+void dispatch(const double* x, double* out, const uword n)
+{
+#ifdef OWL_SIMD_DISPATCH
+  switch (simdLevel()) {
+  case SimdLevel::avx512:
+    mapElementsAvx512<f>(x, out, n);
+    return;
+  case SimdLevel::avx2:
+    mapElementsAvx2<f>(x, out, n);
+    return;
+  default:
+    break;
+  }
+#endif
+
+  mapElements<f>(x, out, n);
+}
+
+} // namespace vector_math
+
+inline mat fastExp(const mat& x)
+{
+  mat out(x.n_rows, x.n_cols);
+  vector_math::dispatch<vector_math::expElement>(x.memptr(),
+                                                 out.memptr(),
+                                                 x.n_elem);
+  return out;
+}
+
+// log(x) for positive (normal) x
+inline mat fastLog(const mat& x)
+{
+  mat out(x.n_rows, x.n_cols);
+  vector_math::dispatch<vector_math::logElement>(x.memptr(),
+                                                 out.memptr(),
+                                                 x.n_elem);
+  return out;
+}
+
+// log(1 + exp(x))
+inline mat log1pExp(const mat& x)
+{
+  mat out(x.n_rows, x.n_cols);
+  vector_math::dispatch<vector_math::log1pExpElement>(x.memptr(),
+                                                      out.memptr(),
+                                                      x.n_elem);
+  return out;
+}
+
+// log(exp(0) + sum(exp(x.row(i)))) for each row of x, that is, with an extra
+// column of zeros (the reference class of the multinomial family)
+inline vec logSumExp(const mat& x)
+{
+  // the largest element of each row, including the zero
+  vec x_max(x.n_rows, fill::zeros);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    x_max = arma::max(x_max, x.col(j));
+
+  vec sums = fastExp(-x_max);
+
+  for (uword j = 0; j < x.n_cols; ++j)
+    sums += fastExp(x.col(j) - x_max);
+
+  return fastLog(sums) + x_max;
+}
+
+} // namespace owl
@@ -20,22 +20,227 @@ BEGIN_RCPP
 END_RCPP
 }
 // owlDense
-Rcpp::List owlDense(arma::mat x, arma::mat y, const Rcpp::List control);
+Rcpp::List owlDense(const arma::mat& x, arma::mat y, const Rcpp::List control);
 RcppExport SEXP _owl_owlDense(SEXP xSEXP, SEXP ySEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< arma::mat >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type x(xSEXP);
     Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
     Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
     rcpp_result_gen = Rcpp::wrap(owlDense(x, y, control));
     return rcpp_result_gen;
 END_RCPP
 }
+// owlCrossValidateDense
+arma::cube owlCrossValidateDense(const arma::mat& x, const arma::mat& y, const arma::mat& folds, const arma::uword n_folds, const arma::sp_mat& warm_start, const std::vector<std::string> measures, const Rcpp::List control);
+RcppExport SEXP _owl_owlCrossValidateDense(SEXP xSEXP, SEXP ySEXP, SEXP foldsSEXP, SEXP n_foldsSEXP, SEXP warm_startSEXP, SEXP measuresSEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::mat& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type folds(foldsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_folds(n_foldsSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type warm_start(warm_startSEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string> >::type measures(measuresSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(owlCrossValidateDense(x, y, folds, n_folds, warm_start, measures, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// owlCrossValidateSparse
+arma::cube owlCrossValidateSparse(arma::sp_mat x, const arma::mat& y, const arma::mat& folds, const arma::uword n_folds, const arma::sp_mat& warm_start, const std::vector<std::string> measures, const Rcpp::List control);
+RcppExport SEXP _owl_owlCrossValidateSparse(SEXP xSEXP, SEXP ySEXP, SEXP foldsSEXP, SEXP n_foldsSEXP, SEXP warm_startSEXP, SEXP measuresSEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::sp_mat >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type folds(foldsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_folds(n_foldsSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type warm_start(warm_startSEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string> >::type measures(measuresSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(owlCrossValidateSparse(x, y, folds, n_folds, warm_start, measures, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// predictDense
+arma::cube predictDense(const arma::mat& x, const arma::sp_mat& coefficients, const arma::vec& path_sigma, const arma::vec& sigma, const bool intercept, const arma::uword m, const std::string family, const std::string type);
+RcppExport SEXP _owl_predictDense(SEXP xSEXP, SEXP coefficientsSEXP, SEXP path_sigmaSEXP, SEXP sigmaSEXP, SEXP interceptSEXP, SEXP mSEXP, SEXP familySEXP, SEXP typeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::mat& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type coefficients(coefficientsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type path_sigma(path_sigmaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type sigma(sigmaSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type m(mSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type family(familySEXP);
+    Rcpp::traits::input_parameter< const std::string >::type type(typeSEXP);
+    rcpp_result_gen = Rcpp::wrap(predictDense(x, coefficients, path_sigma, sigma, intercept, m, family, type));
+    return rcpp_result_gen;
+END_RCPP
+}
+// predictSparse
+arma::cube predictSparse(const arma::sp_mat& x, const arma::sp_mat& coefficients, const arma::vec& path_sigma, const arma::vec& sigma, const bool intercept, const arma::uword m, const std::string family, const std::string type);
+RcppExport SEXP _owl_predictSparse(SEXP xSEXP, SEXP coefficientsSEXP, SEXP path_sigmaSEXP, SEXP sigmaSEXP, SEXP interceptSEXP, SEXP mSEXP, SEXP familySEXP, SEXP typeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type coefficients(coefficientsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type path_sigma(path_sigmaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type sigma(sigmaSEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type m(mSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type family(familySEXP);
+    Rcpp::traits::input_parameter< const std::string >::type type(typeSEXP);
+    rcpp_result_gen = Rcpp::wrap(predictSparse(x, coefficients, path_sigma, sigma, intercept, m, family, type));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sortedL1Prox
+arma::mat sortedL1Prox(const arma::mat& beta, const arma::vec& lambda, const int threads);
+RcppExport SEXP _owl_sortedL1Prox(SEXP betaSEXP, SEXP lambdaSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const arma::mat& >::type beta(betaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(sortedL1Prox(beta, lambda, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// owlMapped
+Rcpp::List owlMapped(const std::string file, const bool sparse, const arma::uword n_rows, const arma::uword n_cols, arma::mat y, const Rcpp::List control);
+RcppExport SEXP _owl_owlMapped(SEXP fileSEXP, SEXP sparseSEXP, SEXP n_rowsSEXP, SEXP n_colsSEXP, SEXP ySEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< const bool >::type sparse(sparseSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_rows(n_rowsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_cols(n_colsSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(owlMapped(file, sparse, n_rows, n_cols, y, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// packGenotypeMatrix
+Rcpp::RawVector packGenotypeMatrix(const Rcpp::IntegerMatrix& x);
+RcppExport SEXP _owl_packGenotypeMatrix(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::IntegerMatrix& >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(packGenotypeMatrix(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// owlGenotype
+Rcpp::List owlGenotype(const Rcpp::RawVector& x, const arma::uword n_rows, const arma::uword n_cols, arma::mat y, const Rcpp::List control);
+RcppExport SEXP _owl_owlGenotype(SEXP xSEXP, SEXP n_rowsSEXP, SEXP n_colsSEXP, SEXP ySEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RawVector& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_rows(n_rowsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_cols(n_colsSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(owlGenotype(x, n_rows, n_cols, y, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// owlPattern
+Rcpp::List owlPattern(const Rcpp::IntegerVector& row_indices, const Rcpp::IntegerVector& col_ptrs, const arma::uword n_rows, const arma::uword n_cols, arma::mat y, const Rcpp::List control);
+RcppExport SEXP _owl_owlPattern(SEXP row_indicesSEXP, SEXP col_ptrsSEXP, SEXP n_rowsSEXP, SEXP n_colsSEXP, SEXP ySEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type row_indices(row_indicesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type col_ptrs(col_ptrsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_rows(n_rowsSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_cols(n_colsSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(owlPattern(row_indices, col_ptrs, n_rows, n_cols, y, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// writeModelFile
+void writeModelFile(const std::string file, const arma::sp_mat& coefficients, const arma::vec& sigma, const arma::vec& lambda, const arma::vec& x_center, const arma::vec& x_scale, const std::string family, const bool intercept, const arma::uword n_targets);
+RcppExport SEXP _owl_writeModelFile(SEXP fileSEXP, SEXP coefficientsSEXP, SEXP sigmaSEXP, SEXP lambdaSEXP, SEXP x_centerSEXP, SEXP x_scaleSEXP, SEXP familySEXP, SEXP interceptSEXP, SEXP n_targetsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< const arma::sp_mat& >::type coefficients(coefficientsSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type sigma(sigmaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type lambda(lambdaSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type x_center(x_centerSEXP);
+    Rcpp::traits::input_parameter< const arma::vec& >::type x_scale(x_scaleSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type family(familySEXP);
+    Rcpp::traits::input_parameter< const bool >::type intercept(interceptSEXP);
+    Rcpp::traits::input_parameter< const arma::uword >::type n_targets(n_targetsSEXP);
+    writeModelFile(file, coefficients, sigma, lambda, x_center, x_scale, family, intercept, n_targets);
+    return R_NilValue;
+END_RCPP
+}
+// readModelFile
+Rcpp::List readModelFile(const std::string file);
+RcppExport SEXP _owl_readModelFile(SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(readModelFile(file));
+    return rcpp_result_gen;
+END_RCPP
+}
+// scoreModelFile
+arma::mat scoreModelFile(const std::string file, const arma::mat& x);
+RcppExport SEXP _owl_scoreModelFile(SEXP fileSEXP, SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< const arma::mat& >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(scoreModelFile(file, x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// shardWorker
+void shardWorker(const int fd);
+RcppExport SEXP _owl_shardWorker(SEXP fdSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const int >::type fd(fdSEXP);
+    shardWorker(fd);
+    return R_NilValue;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
     {"_owl_owlSparse", (DL_FUNC) &_owl_owlSparse, 3},
     {"_owl_owlDense", (DL_FUNC) &_owl_owlDense, 3},
+    {"_owl_owlCrossValidateDense", (DL_FUNC) &_owl_owlCrossValidateDense, 7},
+    {"_owl_owlCrossValidateSparse", (DL_FUNC) &_owl_owlCrossValidateSparse, 7},
+    {"_owl_predictDense", (DL_FUNC) &_owl_predictDense, 8},
+    {"_owl_predictSparse", (DL_FUNC) &_owl_predictSparse, 8},
+    {"_owl_sortedL1Prox", (DL_FUNC) &_owl_sortedL1Prox, 3},
+    {"_owl_owlMapped", (DL_FUNC) &_owl_owlMapped, 6},
+    {"_owl_packGenotypeMatrix", (DL_FUNC) &_owl_packGenotypeMatrix, 1},
+    {"_owl_owlGenotype", (DL_FUNC) &_owl_owlGenotype, 5},
+    {"_owl_owlPattern", (DL_FUNC) &_owl_owlPattern, 6},
+    {"_owl_writeModelFile", (DL_FUNC) &_owl_writeModelFile, 9},
+    {"_owl_readModelFile", (DL_FUNC) &_owl_readModelFile, 1},
+    {"_owl_scoreModelFile", (DL_FUNC) &_owl_scoreModelFile, 2},
+    {"_owl_shardWorker", (DL_FUNC) &_owl_shardWorker, 1},
     {NULL, NULL, 0}
 };
 
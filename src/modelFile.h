@@ -0,0 +1,142 @@
+#pragma once
+
+#include <RcppArmadillo.h>
+#include <string>
+#include <vector>
+#include <owl/model.h>
+
+using namespace Rcpp;
+using namespace arma;
+
+inline owl::ModelFamily modelFamily(const std::string& family)
+{
+  if (family == "binomial")
+    return owl::ModelFamily::binomial;
+  else if (family == "multinomial")
+    return owl::ModelFamily::multinomial;
+  else if (family == "poisson")
+    return owl::ModelFamily::poisson;
+  else
+    return owl::ModelFamily::gaussian;
+}
+
+inline std::string familyName(const owl::ModelFamily family)
+{
+  switch (family) {
+    case owl::ModelFamily::binomial:
+      return "binomial";
+    case owl::ModelFamily::multinomial:
+      return "multinomial";
+    case owl::ModelFamily::poisson:
+      return "poisson";
+    default:
+      return "gaussian";
+  }
+}
+
+// write the coefficients (with the layout of the coefficients slot of a fit)
+// along with the rest of the model
+inline void saveModel(const std::string& file,
+                      const sp_mat& coefficients,
+                      const vec& sigma,
+                      const vec& lambda,
+                      const vec& x_center,
+                      const vec& x_scale,
+                      const std::string& family,
+                      const bool intercept,
+                      const uword n_targets)
+{
+  coefficients.sync();
+
+  const uword n_cols = coefficients.n_cols;
+  const uword n_nonzero = coefficients.n_nonzero;
+
+  owl::writeModel(
+    file,
+    modelFamily(family),
+    intercept,
+    coefficients.n_rows,
+    n_targets,
+    std::vector<double>(sigma.begin(), sigma.end()),
+    std::vector<double>(lambda.begin(), lambda.end()),
+    std::vector<double>(x_center.begin(), x_center.end()),
+    std::vector<double>(x_scale.begin(), x_scale.end()),
+    std::vector<std::uint64_t>(coefficients.col_ptrs,
+                               coefficients.col_ptrs + n_cols + 1),
+    std::vector<std::uint64_t>(coefficients.row_indices,
+                               coefficients.row_indices + n_nonzero),
+    std::vector<double>(coefficients.values,
+                        coefficients.values + n_nonzero)
+  );
+}
+
+// the linear predictors of the observations (rows) of x from the model in
+// file, which are scored one at a time through the mapped model, as a
+// scoring service would, with the columns laid out as in the coefficients
+inline mat scoreModel(const std::string& file, const mat& x)
+{
+  const owl::MappedModel mapped(file);
+  const owl::ModelView& model = mapped.model;
+
+  const uword n_predictors = model.n_rows - (model.intercept ? 1 : 0);
+
+  if (x.n_cols != n_predictors)
+    stop("'x' must have %i columns", n_predictors);
+
+  const uword m = model.n_targets;
+
+  mat out(x.n_rows, m*model.n_sigma);
+  std::vector<double> x_i(n_predictors);
+  std::vector<double> eta(m);
+
+  for (uword i = 0; i < x.n_rows; ++i) {
+    for (uword j = 0; j < n_predictors; ++j)
+      x_i[j] = x(i, j);
+
+    for (uword k = 0; k < model.n_sigma; ++k) {
+      model.linearPredictor(x_i.data(), k, eta.data());
+
+      for (uword t = 0; t < m; ++t)
+        out(i, k*m + t) = eta[t];
+    }
+  }
+
+  return out;
+}
+
+// read a model through a memory mapping, as a scoring service would
+inline List loadModel(const std::string& file)
+{
+  const owl::MappedModel mapped(file);
+  const owl::ModelView& model = mapped.model;
+
+  const uword n_cols = model.n_targets*model.n_sigma;
+
+  const uvec col_ptrs(std::vector<uword>(model.col_ptrs,
+                                         model.col_ptrs + n_cols + 1));
+  const uvec row_indices(std::vector<uword>(model.row_indices,
+                                            model.row_indices
+                                            + model.n_nonzero));
+  const vec values(model.values, model.n_nonzero);
+
+  const sp_mat coefficients(row_indices,
+                            col_ptrs,
+                            values,
+                            model.n_rows,
+                            n_cols);
+
+  return List::create(
+    Named("coefficients") = wrap(coefficients),
+    Named("family")       = familyName(model.family),
+    Named("intercept")    = model.intercept,
+    Named("n_targets")    = static_cast<double>(model.n_targets),
+    Named("sigma")        = NumericVector(model.sigma,
+                                          model.sigma + model.n_sigma),
+    Named("lambda")       = NumericVector(model.lambda,
+                                          model.lambda + model.n_lambda),
+    Named("x_center")     = NumericVector(model.x_center,
+                                          model.x_center + model.n_rows),
+    Named("x_scale")      = NumericVector(model.x_scale,
+                                          model.x_scale + model.n_rows)
+  );
+}
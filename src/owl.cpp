@@ -1,412 +1,444 @@
 #include <RcppArmadillo.h>
 #include <memory>
-#include "results.h"
-#include "families/families.h"
-#include "screening.h"
-#include "standardize.h"
-#include "rescale.h"
-#include "regularizationPath.h"
-#include "kktCheck.h"
+#include <owl/owl.h>
+#include "modelFile.h"
 
+// the bindings between R and the core in inst/include/owl
 using namespace Rcpp;
 using namespace arma;
+using namespace owl;
 
-template <typename T>
-List owlCpp(T& x, mat& y, const List control)
+// progress is printed to the R console, and user interrupts (which can only
+// be checked for on the main thread) cancel the fit
+inline FitHooks rHooks()
 {
-  using std::endl;
-  using std::setw;
-  using std::showpoint;
+  FitHooks hooks;
 
-  // significant digits
-  Rcout.precision(4);
+  hooks.log = [](const std::string& line) {
+    if (!onWorkerThread())
+      Rcout << line << std::endl;
+  };
 
-  auto tol_dev_ratio = as<double>(control["tol_dev_ratio"]);
-  auto tol_dev_change = as<double>(control["tol_dev_change"]);
-  auto max_variables = as<uword>(control["max_variables"]);
+  hooks.cancelled = []() {
+    if (!onWorkerThread())
+      Rcpp::checkUserInterrupt();
 
-  auto diagnostics = as<bool>(control["diagnostics"]);
-  auto verbosity = as<uword>(control["verbosity"]);
+    return false;
+  };
 
-  // solver arguments
-  auto max_passes  = as<uword>(control["max_passes"]);
-  auto tol_rel_gap = as<double>(control["tol_rel_gap"]);
-  auto tol_infeas  = as<double>(control["tol_infeas"]);
-  auto tol_abs     = as<double>(control["tol_abs"]);
-  auto tol_rel     = as<double>(control["tol_rel"]);
+  return hooks;
+}
 
-  auto family_choice = as<std::string>(control["family"]);
-  auto intercept = as<bool>(control["fit_intercept"]);
-  auto screening = as<bool>(control["screening"]);
-
-  auto n = x.n_rows;
-  auto p = x.n_cols;
-  auto m = y.n_cols;
-
-  auto center = as<bool>(control["center"]);
-  auto scale = as<std::string>(control["scale"]);
-
-  auto y_center = as<rowvec>(control["y_center"]);
-  auto y_scale = as<rowvec>(control["y_scale"]);
-  rowvec x_center(p, fill::zeros);
-  rowvec x_scale(p, fill::ones);
-
-  standardize(x, x_center, x_scale, intercept, center, scale);
-
-  auto lambda = as<vec>(control["lambda"]);
-  auto sigma  = as<vec>(control["sigma"]);
-  auto lambda_type = as<std::string>(control["lambda_type"]);
-  auto sigma_type = as<std::string>(control["sigma_type"]);
-  auto lambda_min_ratio = as<double>(control["lambda_min_ratio"]);
-  auto q = as<double>(control["q"]);
-  uword n_sigma = sigma.n_elem;
-  double sigma_max = 0;
-
-  regularizationPath(sigma,
-                     lambda,
-                     sigma_max,
-                     x,
-                     y,
-                     y_scale,
-                     lambda_type,
-                     sigma_type,
-                     lambda_min_ratio,
-                     q,
-                     family_choice,
-                     intercept);
-
-  auto family = setupFamily(family_choice,
-                            intercept,
-                            diagnostics,
-                            max_passes,
-                            tol_rel_gap,
-                            tol_infeas,
-                            tol_abs,
-                            tol_rel,
-                            verbosity);
-
-  cube betas(p, m, n_sigma, fill::zeros);
-  mat beta(p, m, fill::zeros);
-
-  uword n_variables = 0;
-  uvec n_unique(n_sigma);
-
-  mat linear_predictor = x*beta;
-
-  double null_deviance = 2*family->primal(y, linear_predictor);
-  std::vector<double> deviances;
-  std::vector<double> deviance_ratios;
-  double deviance_change{0};
-
-  mat beta_prev(p, m, fill::zeros);
-
-  uvec passes(n_sigma);
-  std::vector<std::vector<double>> primals;
-  std::vector<std::vector<double>> duals;
-  std::vector<std::vector<double>> timings;
-  std::vector<unsigned> violations;
-  std::vector<std::vector<unsigned>> violation_list;
-
-  mat linear_predictor_prev(n, m);
-  mat gradient_prev(p, m);
-  mat pseudo_gradient_prev(n, m);
-
-  // sets of active predictors
-  field<uvec> active_sets(n_sigma);
-  uvec active_set = regspace<uvec>(0, p-1);
-  uvec strong_set;
-  uvec ever_active_set;
-  if (intercept)
-    ever_active_set.insert_rows(0, 1);
-
-  // object for use in ADMM
-  double rho = 0.0;
-  vec z(p);
-  vec u(p);
-  vec z_subset(z);
-  vec u_subset(u);
-  // for gaussian case
-  mat xx, L, U;
-  vec xTy;
-  T x_subset;
-
-  // factorize xx if gaussian
-  if (family->name() == "gaussian") {
-    // initialize auxiliary variables
-    z.zeros();
-    u.zeros();
+// read the settings of a fit from the control list passed from R
+inline PathSettings pathSettings(const List& control)
+{
+  PathSettings settings;
+
+  settings.family           = as<std::string>(control["family"]);
+  settings.intercept        = as<bool>(control["fit_intercept"]);
+  settings.center           = as<bool>(control["center"]);
+  settings.scale            = as<std::string>(control["scale"]);
+  settings.n_targets        = as<uword>(control["n_targets"]);
+  settings.screening        = as<bool>(control["screening"]);
+  settings.adaptive         = as<bool>(control["adaptive"]);
+  settings.tol_adaptive     = as<double>(control["tol_adaptive"]);
+  settings.sigma            = as<vec>(control["sigma"]);
+  settings.sigma_type       = as<std::string>(control["sigma_type"]);
+  settings.lambda           = as<vec>(control["lambda"]);
+  settings.lambda_type      = as<std::string>(control["lambda_type"]);
+  settings.lambda_min_ratio = as<double>(control["lambda_min_ratio"]);
+  settings.q                = as<vec>(control["q"]);
+  settings.y_center         = as<rowvec>(control["y_center"]);
+  settings.y_scale          = as<rowvec>(control["y_scale"]);
+  settings.max_passes       = as<uword>(control["max_passes"]);
+  settings.max_time         = as<double>(control["max_time"]);
+  settings.diagnostics      = as<bool>(control["diagnostics"]);
+  settings.verbosity        = as<uword>(control["verbosity"]);
+  settings.max_variables    = as<uword>(control["max_variables"]);
+  settings.tol_dev_change   = as<double>(control["tol_dev_change"]);
+  settings.tol_dev_ratio    = as<double>(control["tol_dev_ratio"]);
+  settings.tol_rel_gap      = as<double>(control["tol_rel_gap"]);
+  settings.tol_infeas       = as<double>(control["tol_infeas"]);
+  settings.tol_abs          = as<double>(control["tol_abs"]);
+  settings.tol_rel          = as<double>(control["tol_rel"]);
+  settings.n_shards         = as<uword>(control["shards"]);
+  settings.pipelined        = as<bool>(control["pipeline"]);
+  settings.hooks            = rHooks();
+
+  if (control.containsElementNamed("shard_worker"))
+    settings.shard_worker =
+      as<std::vector<std::string>>(control["shard_worker"]);
+
+  settings.resume = control.containsElementNamed("state")
+                    && !Rf_isNull(control["state"]);
+
+  if (settings.resume) {
+    const List state = as<List>(control["state"]);
+
+    settings.state.x_center        = as<rowvec>(state["x_center"]);
+    settings.state.x_scale         = as<rowvec>(state["x_scale"]);
+    settings.state.lambda          = as<vec>(state["lambda"]);
+    settings.state.sigma_max       = as<double>(state["sigma_max"]);
+    settings.state.sigma           = as<double>(state["sigma"]);
+    settings.state.beta            = as<mat>(state["beta"]);
+    settings.state.z               = as<vec>(state["z"]);
+    settings.state.u               = as<vec>(state["u"]);
+    settings.state.ever_active_set = as<uvec>(state["ever_active_set"]);
+    settings.state.null_deviance   = as<double>(state["null_deviance"]);
   }
 
-  bool factorized = false;
-
-  Results res;
-
-  uword k = 0;
-
-  while (k < n_sigma) {
-
-    violations.clear();
-
-    if (screening) {
-      // NOTE(JL): the screening rules should probably not be used if
-      // the coefficients from the previous fit are already very dense
-
-      // step 1: compute strong set
-      gradient_prev = family->gradient(x, y, x*beta_prev);
-
-      double sigma_prev = k == 0 ? sigma_max : sigma(k-1);
-
-      strong_set = activeSet(gradient_prev,
-                             lambda*sigma(k),
-                             lambda*sigma_prev,
-                             intercept);
-
-      // step 2: start by fitting for ever active set
-      uvec prev_active = find(any(beta_prev != 0, 1));
-
-      ever_active_set = setUnion(ever_active_set, prev_active);
-      active_set = ever_active_set;
-    }
-
-    if (active_set.n_elem == p/m || !screening) {
-
-      // stop screening
-      screening = false;
-
-      // all features active
-      // factorize once if fitting all
-      if (!factorized && family->name() == "gaussian") {
-        // precompute x^Ty
-        xTy = x.t() * y;
-
-        // precompute X^tX or XX^t (if wide) and factorize
-        if (n >= p) {
-          xx = x.t() * x;
-        } else {
-          xx = x*x.t();
-        }
-
-        // TODO(jolars): should rho be updated for each new run?
-        vec eigval = eig_sym(xx);
-        rho =
-          std::pow(eigval.max(), 1/3)*std::pow(lambda.max()*sigma(k), 2/3);
-
-        if (n < p)
-          xx /= rho;
-
-        xx.diag() += rho;
-
-        L = chol(xx, "lower");
-        U = L.t();
-
-        factorized = true;
-      }
-
-      res = family->fit(x, y, beta, z, u, L, U, xTy, lambda*sigma(k), rho);
-      passes(k) = res.passes;
-      beta = res.beta;
-
-      if (diagnostics) {
-        primals.push_back(res.primals);
-        duals.push_back(res.duals);
-        timings.push_back(res.time);
-        violation_list.push_back(violations);
-      }
-
-    } else {
-
-      bool kkt_violation = true;
+  return settings;
+}
 
-      do {
-        x_subset = matrixSubset(x, active_set);
+// the results of a path for R
+inline List wrapPath(const PathFit& fit, const std::string& family)
+{
+  List state = List::create(
+    Named("family")          = family,
+    Named("x_center")        = wrap(fit.state.x_center),
+    Named("x_scale")         = wrap(fit.state.x_scale),
+    Named("lambda")          = wrap(fit.state.lambda),
+    Named("sigma_max")       = fit.state.sigma_max,
+    Named("sigma")           = fit.state.sigma,
+    Named("beta")            = wrap(fit.state.beta),
+    Named("z")               = wrap(fit.state.z),
+    Named("u")               = wrap(fit.state.u),
+    Named("ever_active_set") = wrap(fit.state.ever_active_set),
+    Named("null_deviance")   = fit.state.null_deviance
+  );
 
-        if (active_set.n_elem == 0) {
-          // null model
-          beta.zeros();
-          passes(k) = 0;
+  return List::create(
+    Named("betas")               = wrap(fit.coefficients),
+    Named("active_sets")         = wrap(fit.active_sets),
+    Named("passes")              = wrap(fit.passes),
+    Named("primals")             = wrap(fit.primals),
+    Named("duals")               = wrap(fit.duals),
+    Named("time")                = wrap(fit.time),
+    Named("n_unique")            = wrap(fit.n_unique),
+    Named("violations")          = wrap(fit.violations),
+    Named("deviance_ratio")      = wrap(fit.deviance_ratio),
+    Named("null_deviance")       = wrap(fit.null_deviance),
+    Named("interpolated")        = wrap(fit.interpolated),
+    Named("converged")           = wrap(fit.converged),
+    Named("timed_out")           = wrap(fit.timed_out),
+    Named("state")               = state,
+    Named("sigma")               = wrap(fit.sigma),
+    Named("lambda")              = wrap(fit.lambda)
+  );
+}
 
-        } else {
+// fit the paths for each q in the control list, returning a list of them
+template <typename T>
+List owlCpp(T& x, mat& y, const vec& weights, const List control)
+{
+  const PathSettings settings = pathSettings(control);
 
-          if (family->name() == "gaussian") {
-            if (x_subset.n_rows >= x_subset.n_cols) {
-              xx = x_subset.t()*x_subset;
-            } else {
-              xx = x_subset*x_subset.t();
-            }
+  // the number of threads for the products and column statistics
+  ThreadCount thread_count(as<int>(control["threads"]));
 
-            vec eigval = eig_sym(xx);
-            rho =
-              std::pow(eigval.max(), 1/3)*std::pow(lambda.max()*sigma(k), 2/3);
+  const std::vector<PathFit> fits = fitPaths(x, y, weights, settings);
 
-            if (x_subset.n_rows < x_subset.n_cols)
-              xx /= rho;
+  List out(fits.size());
 
-            xx.diag() += rho;
+  for (uword i = 0; i < fits.size(); ++i)
+    out[i] = wrapPath(fits[i], settings.family);
 
-            L = chol(xx, "lower");
-            U = L.t();
+  return out;
+}
 
-            xTy = x_subset.t() * y;
+// [[Rcpp::export]]
+Rcpp::List owlSparse(arma::sp_mat x,
+                     arma::mat y,
+                     const Rcpp::List control)
+{
+  // take over the converted data, which is centered and scaled implicitly so
+  // that the sparsity of x is preserved
+  auto intercept = as<bool>(control["fit_intercept"]);
+  auto weights = as<vec>(control["weights"]);
 
-            z_subset = z(active_set);
-            u_subset = u(active_set);
-          }
+  if (as<bool>(control["compress"])) {
+    // fit the distinct observations, weighted by their multiplicities
+    const CompressedRows compressed = compressRows(x, y, weights);
 
-          uword n_active = (active_set.n_elem - static_cast<uword>(intercept))*m;
+    if (compressed.rows.n_elem < x.n_rows) {
+      x = sp_mat(matrixSubset(sp_mat(x.t()), compressed.rows).t());
+      y = mat(y.rows(compressed.rows));
+      weights = compressed.weights;
+    }
+  }
 
-          res = family->fit(x_subset,
-                            y,
-                            beta.rows(active_set),
-                            z_subset,
-                            u_subset,
-                            L,
-                            U,
-                            xTy,
-                            lambda.head(n_active)*sigma(k),
-                            rho);
+  // store dense columns separately if there are both dense and sparse ones
+  const uvec is_dense = denseColumns(x);
 
-          if (family->name() == "gaussian") {
-            z(active_set) = z_subset;
-            u(active_set) = u_subset;
-          }
+  if (any(is_dense) && !all(is_dense)) {
+    HybridMatrix x_hybrid = hybridMatrix(x, is_dense);
+    x.reset();
 
-          beta.rows(active_set) = res.beta;
-          passes(k) = res.passes;
-        }
+    StandardizedMatrix<HybridMatrix> x_std(
+      std::make_shared<const HybridMatrix>(std::move(x_hybrid)),
+      intercept
+    );
 
-        gradient_prev = family->gradient(x, y, x*beta);
+    return owlCpp(x_std, y, weights, control);
+  }
 
-        uvec possible_failures =
-          kktCheck(gradient_prev, beta, lambda*sigma(k), tol_infeas, intercept);
+  StandardizedMatrix<sp_mat> x_std(
+    std::make_shared<const sp_mat>(std::move(x)),
+    intercept
+  );
 
-        uvec strong_failures = intersect(possible_failures, strong_set);
+  return owlCpp(x_std, y, weights, control);
+}
 
-        uvec check_failures = setDiff(strong_failures, active_set);
+// [[Rcpp::export]]
+Rcpp::List owlDense(const arma::mat& x,
+                    arma::mat y,
+                    const Rcpp::List control)
+{
+  auto intercept = as<bool>(control["fit_intercept"]);
+  auto weights = as<vec>(control["weights"]);
 
-        if (verbosity >= 2) {
-          Rcout << "kkt-failures at: " << std::endl;
-          check_failures.print();
-          Rcout << std::endl;
-        }
+  if (as<bool>(control["compress"])) {
+    // fit the distinct observations, weighted by their multiplicities
+    const CompressedRows compressed = compressRows(x, y, weights);
 
-        kkt_violation = check_failures.n_elem > 0;
+    if (compressed.rows.n_elem < x.n_rows) {
+      StandardizedMatrix<mat> x_std(
+        std::make_shared<const mat>(x.rows(compressed.rows)),
+        intercept
+      );
+      mat y_compressed = y.rows(compressed.rows);
 
-        if (diagnostics)
-          violations.push_back(check_failures.n_elem);
+      return owlCpp(x_std, y_compressed, compressed.weights, control);
+    }
+  }
 
-        if (!kkt_violation) {
-          // check against whole set
-          check_failures = setDiff(possible_failures, active_set);
+  // wrap (without copying) the data from R, which is standardized implicitly
+  StandardizedMatrix<mat> x_std(
+    std::shared_ptr<const mat>(&x, [](const mat*) {}),
+    intercept
+  );
 
-          kkt_violation = check_failures.n_elem > 0;
+  return owlCpp(x_std, y, weights, control);
+}
 
-          if (diagnostics)
-            violations.push_back(check_failures.n_elem);
-        }
+// the number of threads for cross-validation, where 0 means the OpenMP
+// default
+inline int crossValidationThreads(const List& control)
+{
+  const int threads = as<int>(control["threads"]);
+  return threads > 0 ? threads : maxThreads();
+}
 
-        active_set = setUnion(check_failures, active_set);
+// [[Rcpp::export]]
+arma::cube owlCrossValidateDense(const arma::mat& x,
+                                 const arma::mat& y,
+                                 const arma::mat& folds,
+                                 const arma::uword n_folds,
+                                 const arma::sp_mat& warm_start,
+                                 const std::vector<std::string> measures,
+                                 const Rcpp::List control)
+{
+  // all folds share the data from R, which is neither copied nor subset
+  return crossValidate(std::shared_ptr<const mat>(&x, [](const mat*) {}),
+                       y,
+                       as<vec>(control["weights"]),
+                       conv_to<umat>::from(folds),
+                       n_folds,
+                       pathSettings(control),
+                       warm_start,
+                       measures,
+                       crossValidationThreads(control));
+}
 
-        checkUserInterrupt();
+// [[Rcpp::export]]
+arma::cube owlCrossValidateSparse(arma::sp_mat x,
+                                  const arma::mat& y,
+                                  const arma::mat& folds,
+                                  const arma::uword n_folds,
+                                  const arma::sp_mat& warm_start,
+                                  const std::vector<std::string> measures,
+                                  const Rcpp::List control)
+{
+  // the compressed format must be up to date before the threads share it
+  x.sync();
+
+  return crossValidate(std::make_shared<const sp_mat>(std::move(x)),
+                       y,
+                       as<vec>(control["weights"]),
+                       conv_to<umat>::from(folds),
+                       n_folds,
+                       pathSettings(control),
+                       warm_start,
+                       measures,
+                       crossValidationThreads(control));
+}
 
-      } while (kkt_violation);
+// [[Rcpp::export]]
+arma::cube predictDense(const arma::mat& x,
+                        const arma::sp_mat& coefficients,
+                        const arma::vec& path_sigma,
+                        const arma::vec& sigma,
+                        const bool intercept,
+                        const arma::uword m,
+                        const std::string family,
+                        const std::string type)
+{
+  return predictPath(x,
+                     coefficients,
+                     intercept,
+                     m,
+                     interpolatePath(path_sigma, sigma),
+                     family,
+                     type);
+}
 
-      if (diagnostics) {
-        primals.push_back(res.primals);
-        duals.push_back(res.duals);
-        timings.push_back(res.time);
-        violation_list.push_back(violations);
-      }
-    }
+// [[Rcpp::export]]
+arma::cube predictSparse(const arma::sp_mat& x,
+                         const arma::sp_mat& coefficients,
+                         const arma::vec& path_sigma,
+                         const arma::vec& sigma,
+                         const bool intercept,
+                         const arma::uword m,
+                         const std::string family,
+                         const std::string type)
+{
+  return predictPath(x,
+                     coefficients,
+                     intercept,
+                     m,
+                     interpolatePath(path_sigma, sigma),
+                     family,
+                     type);
+}
 
-    // store coefficients and intercept
-    double deviance = res.deviance;
-    double deviance_ratio = 1.0 - deviance/null_deviance;
-    deviances.push_back(deviance);
-    deviance_ratios.push_back(deviance_ratio);
+// [[Rcpp::export]]
+arma::mat sortedL1Prox(const arma::mat& beta,
+                       const arma::vec& lambda,
+                       const int threads)
+{
+  return prox(beta, lambda, threads);
+}
 
-    if (k > 0) {
-      deviance_change =
-        std::abs((deviances[k-1] - deviance)/deviances[k-1]);
-    }
+// [[Rcpp::export]]
+Rcpp::List owlMapped(const std::string file,
+                     const bool sparse,
+                     const arma::uword n_rows,
+                     const arma::uword n_cols,
+                     arma::mat y,
+                     const Rcpp::List control)
+{
+  // map the file into memory, from which columns are read on demand
+  auto intercept = as<bool>(control["fit_intercept"]);
+  auto weights = as<vec>(control["weights"]);
+
+  if (sparse) {
+    StandardizedMatrix<MappedSparseMatrix> x_std(
+      std::make_shared<const MappedSparseMatrix>(file, n_rows, n_cols),
+      intercept
+    );
+
+    return owlCpp(x_std, y, weights, control);
+  } else {
+    StandardizedMatrix<MappedDenseMatrix> x_std(
+      std::make_shared<const MappedDenseMatrix>(file, n_rows, n_cols),
+      intercept
+    );
+
+    return owlCpp(x_std, y, weights, control);
+  }
+}
 
-    betas.slice(k) = beta;
-    beta_prev = beta;
-
-    active_sets(k) = active_set;
-    uword n_coefs = accu(any(beta != 0, 1));
-    n_variables = n_coefs;
-    n_unique(k) = unique(abs(nonzeros(beta))).eval().n_elem;
-
-    if (verbosity >= 1)
-      Rcout << showpoint
-            << "penalty: "      << setw(2) << k
-            << ", dev: "        << setw(7) << deviance
-            << ", dev ratio: "  << setw(7) << deviance_ratio
-            << ", dev change: " << setw(7) << deviance_change
-            << ", n var: "      << setw(5) << n_variables
-            << ", n unique: "   << setw(5) << n_unique(k)
-            << endl;
-
-    if (n_coefs > 0 && k > 0) {
-      // stop path if fractional deviance change is small
-      if (deviance_change < tol_dev_change || deviance_ratio > tol_dev_ratio) {
-        k++;
-        break;
-      }
-    }
+// [[Rcpp::export]]
+Rcpp::RawVector packGenotypeMatrix(const Rcpp::IntegerMatrix& x)
+{
+  const std::vector<unsigned char> data =
+    packGenotypes(x.begin(), x.nrow(), x.ncol());
 
-    if (n_unique(k) > max_variables)
-      break;
+  return Rcpp::RawVector(data.begin(), data.end());
+}
 
-    k++;
+// [[Rcpp::export]]
+Rcpp::List owlGenotype(const Rcpp::RawVector& x,
+                       const arma::uword n_rows,
+                       const arma::uword n_cols,
+                       arma::mat y,
+                       const Rcpp::List control)
+{
+  // use the packed genotypes from R without copying them
+  auto intercept = as<bool>(control["fit_intercept"]);
+  auto weights = as<vec>(control["weights"]);
+  StandardizedMatrix<GenotypeMatrix> x_std(
+    std::make_shared<const GenotypeMatrix>(RAW(x), n_rows, n_cols),
+    intercept
+  );
 
-    checkUserInterrupt();
-  }
+  return owlCpp(x_std, y, weights, control);
+}
 
-  betas.resize(p, m, k);
-  passes.resize(k);
-  sigma.resize(k);
-  n_unique.resize(k);
-  active_sets = active_sets.rows(0, std::max(static_cast<int>(k-1), 0));
+// [[Rcpp::export]]
+Rcpp::List owlPattern(const Rcpp::IntegerVector& row_indices,
+                      const Rcpp::IntegerVector& col_ptrs,
+                      const arma::uword n_rows,
+                      const arma::uword n_cols,
+                      arma::mat y,
+                      const Rcpp::List control)
+{
+  // use the index slots of the ngCMatrix from R without copying them
+  auto intercept = as<bool>(control["fit_intercept"]);
+  auto weights = as<vec>(control["weights"]);
+  StandardizedMatrix<PatternMatrix> x_std(
+    std::make_shared<const PatternMatrix>(col_ptrs.begin(),
+                                          row_indices.begin(),
+                                          n_rows,
+                                          n_cols),
+    intercept
+  );
 
-  rescale(betas,
-          x_center,
-          x_scale,
-          y_center,
-          y_scale,
-          intercept);
+  return owlCpp(x_std, y, weights, control);
+}
 
-  // standardize lambda
-  lambda /= n;
+// [[Rcpp::export]]
+void writeModelFile(const std::string file,
+                    const arma::sp_mat& coefficients,
+                    const arma::vec& sigma,
+                    const arma::vec& lambda,
+                    const arma::vec& x_center,
+                    const arma::vec& x_scale,
+                    const std::string family,
+                    const bool intercept,
+                    const arma::uword n_targets)
+{
+  saveModel(file,
+            coefficients,
+            sigma,
+            lambda,
+            x_center,
+            x_scale,
+            family,
+            intercept,
+            n_targets);
+}
 
-  return List::create(
-    Named("betas")               = wrap(betas),
-    Named("active_sets")         = wrap(active_sets),
-    Named("passes")              = wrap(passes),
-    Named("primals")             = wrap(primals),
-    Named("duals")               = wrap(duals),
-    Named("time")                = wrap(timings),
-    Named("n_unique")            = wrap(n_unique),
-    Named("violations")          = wrap(violation_list),
-    Named("deviance_ratio")      = wrap(deviance_ratios),
-    Named("null_deviance")       = wrap(null_deviance),
-    Named("sigma")               = wrap(sigma),
-    Named("lambda")              = wrap(lambda)
-  );
+// [[Rcpp::export]]
+Rcpp::List readModelFile(const std::string file)
+{
+  return loadModel(file);
 }
 
 // [[Rcpp::export]]
-Rcpp::List owlSparse(arma::sp_mat x,
-                     arma::mat y,
-                     const Rcpp::List control)
+arma::mat scoreModelFile(const std::string file, const arma::mat& x)
 {
-  return owlCpp(x, y, control);
+  return scoreModel(file, x);
 }
 
+// The entry point of a shard worker (see shardWorkerCommand() in R), which
+// serves its shard on the socket fd that it inherits from the coordinator.
+// One worker runs for each shard, so each uses a single thread.
 // [[Rcpp::export]]
-Rcpp::List owlDense(arma::mat x,
-                    arma::mat y,
-                    const Rcpp::List control)
+void shardWorker(const int fd)
 {
-  return owlCpp(x, y, control);
+  ThreadCount thread_count(1);
+
+  serveShard(fd);
 }